@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_ADAPTIVE_LOCK_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_ADAPTIVE_LOCK_H
+
+#include <atomic>
+#include <cstdint>
+
+#include "lock_base.h"
+#include "thread_info.h"
+
+#if defined(__has_feature)
+#if __has_feature(thread_sanitizer)
+#define ADAPTIVE_LOCK_TSAN_ENABLED
+#endif
+#elif defined(__SANITIZE_THREAD__)
+#define ADAPTIVE_LOCK_TSAN_ENABLED
+#endif
+
+#ifdef ADAPTIVE_LOCK_TSAN_ENABLED
+#include <sanitizer/tsan_interface.h>
+// Thread sanitizer knows nothing about futex, so tell it where the locks are taken and released.
+#define ADAPTIVE_LOCK_TSAN_ANNOTATE(annotation) annotation
+#else
+#define ADAPTIVE_LOCK_TSAN_ANNOTATE(annotation)
+#endif
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+/*
+ * Lock which spins for a while before sleeping on futex.
+ *
+ * Critical sections of event queue are short, so the lock is usually released before a contending thread
+ * would have been scheduled out. The spin count adapts to how long the lock has been held recently,
+ * and no spinning is done on single core devices.
+ */
+class AdaptiveLock final : public LockBase {
+public:
+    AdaptiveLock()
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_create(this, 0));
+    }
+    ~AdaptiveLock() override
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_destroy(this, 0));
+    }
+
+    void lock() override
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_pre_lock(this, 0));
+        int32_t expected = UNLOCKED;
+        if (__builtin_expect(!state_.compare_exchange_strong(expected, LOCKED, std::memory_order_acquire,
+            std::memory_order_relaxed), 0)) {
+            LockSlow();
+        }
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_post_lock(this, 0, 0));
+    }
+
+    void unlock() override
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_pre_unlock(this, 0));
+        if (__builtin_expect(state_.exchange(UNLOCKED, std::memory_order_release) == CONTENDED, 0)) {
+            WakeOne();
+        }
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_post_unlock(this, 0));
+    }
+
+private:
+    static constexpr int32_t UNLOCKED = 0;
+    static constexpr int32_t LOCKED = 1;
+    // Locked, and there may be threads sleeping on futex.
+    static constexpr int32_t CONTENDED = 2;
+
+    LOCAL_API void LockSlow();
+    LOCAL_API void WakeOne();
+
+    std::atomic<int32_t> state_ {UNLOCKED};
+    // Estimated spin count, updated only by the thread which has taken the lock after spinning.
+    std::atomic<int32_t> spinCount_ {0};
+};
+
+/*
+ * Adaptive lock with priority inheritance, fit for queues of threads with high priority.
+ *
+ * Uncontended locking stores the kernel thread id of owner by a single compare-and-swap. After spinning,
+ * contending threads sleep on a priority inheritance futex, so that the kernel boosts the owner.
+ */
+class AdaptivePriorityInheritanceLock final : public LockBase {
+public:
+    AdaptivePriorityInheritanceLock()
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_create(this, 0));
+    }
+    ~AdaptivePriorityInheritanceLock() override
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_destroy(this, 0));
+    }
+
+    void lock() override
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_pre_lock(this, 0));
+        uint32_t expected = 0;
+        if (__builtin_expect(!owner_.compare_exchange_strong(expected, GetOwnerId(), std::memory_order_acquire,
+            std::memory_order_relaxed), 0)) {
+            LockSlow();
+        }
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_post_lock(this, 0, 0));
+    }
+
+    void unlock() override
+    {
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_pre_unlock(this, 0));
+        uint32_t expected = GetOwnerId();
+        if (__builtin_expect(!owner_.compare_exchange_strong(expected, 0, std::memory_order_release,
+            std::memory_order_relaxed), 0)) {
+            // Waiters are recorded by kernel, let it hand over the lock.
+            UnlockSlow();
+        }
+        ADAPTIVE_LOCK_TSAN_ANNOTATE(__tsan_mutex_post_unlock(this, 0));
+    }
+
+private:
+    static inline uint32_t GetOwnerId()
+    {
+        return static_cast<uint32_t>(ThreadInfo::GetKernelThreadId());
+    }
+
+    LOCAL_API void LockSlow();
+    LOCAL_API void UnlockSlow();
+
+    // Kernel thread id of owner, with waiters bit set by kernel, as required by priority inheritance futex.
+    std::atomic<uint32_t> owner_ {0};
+    std::atomic<int32_t> spinCount_ {0};
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_ADAPTIVE_LOCK_H
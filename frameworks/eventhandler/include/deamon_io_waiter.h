@@ -77,6 +77,7 @@ private:
     std::atomic<bool> isFinished_ = false;
     std::unique_ptr<std::thread> epollThread_;
     std::map<int32_t, std::shared_ptr<FileDescriptorInfo>> fileDescriptorMap_;
+    std::atomic<size_t> fileDescriptorCount_{0};
 };
 }  // namespace AppExecFwk
 }  // namespace OHOS
@@ -19,6 +19,8 @@
 #include <atomic>
 #include <map>
 #include <mutex>
+#include <utility>
+#include <vector>
 
 #include <sys/epoll.h>
 #include "io_waiter.h"
@@ -31,7 +33,13 @@ namespace OHOS {
 namespace AppExecFwk {
 class EventHandler;
 
-// Use epoll to listen file descriptor.
+/*
+ * Use epoll to listen file descriptor.
+ *
+ * Each listened file descriptor is registered with the address of its record, so ready events are dispatched
+ * without looking up the map. Records removed while a thread may be dispatching are retired instead of released,
+ * until all threads which were waiting at that time have left 'WaitFor'.
+ */
 class EpollIoWaiter final : public IoWaiter {
 public:
     EpollIoWaiter() = default;
@@ -56,17 +64,48 @@ public:
     void RemoveFileDescriptor(int32_t fileDescriptor) final;
 
     LOCAL_API void SetFileDescriptorEventCallback(const FileDescriptorEventCallback &callback) final;
-    LOCAL_API void InsertFileDescriptorMap(int32_t fileDescriptor, const std::string& taskName,
-        EventQueue::Priority priority, const std::shared_ptr<FileDescriptorListener>& listener);
+    LOCAL_API std::shared_ptr<FileDescriptorInfo> InsertFileDescriptorMap(int32_t fileDescriptor,
+        const std::string& taskName, EventQueue::Priority priority,
+        const std::shared_ptr<FileDescriptorListener>& listener, uint32_t epollEvents = 0);
     LOCAL_API void EraseFileDescriptorMap(int32_t fileDescriptor);
     LOCAL_API std::shared_ptr<FileDescriptorInfo> GetFileDescriptorMap(int32_t fileDescriptor) override;
+
+    /**
+     * Wait with epoll_pwait2 if supported by kernel, otherwise with a timer file descriptor.
+     */
+    LOCAL_API void EnableHighResolution() final;
+
+    LOCAL_API void SetMaxEventsPerWait(uint32_t maxEvents) final;
+    LOCAL_API bool RearmFileDescriptor(int32_t fileDescriptor) final;
 private:
+    LOCAL_API size_t GetMaxEventsPerWait() const;
+    LOCAL_API void DispatchEvents(struct epoll_event *epollEvents, int32_t count, bool vsyncOnly);
+    LOCAL_API bool Rearm(FileDescriptorInfo &fdInfo);
+    LOCAL_API void EnterWaiting();
+    LOCAL_API void LeaveWaiting();
+    LOCAL_API void RetireLocked(std::shared_ptr<FileDescriptorInfo> &&fdInfo);
+    LOCAL_API void ReclaimRetired(uint32_t generation);
     LOCAL_API void DrainAwakenPipe() const;
+    LOCAL_API void DrainTimer() const;
+    LOCAL_API int32_t Wait(struct epoll_event *events, int32_t maxEvents, int64_t nanoseconds);
+    LOCAL_API int32_t WaitWithTimer(struct epoll_event *events, int32_t maxEvents, int64_t nanoseconds);
 
     // File descriptor for epoll.
     int32_t epollFd_{-1};
     // File descriptor used to wake up epoll.
     int32_t awakenFd_{-1};
+    // Timer file descriptor used to time out in high resolution, only if epoll_pwait2 is not supported.
+    int32_t timerFd_{-1};
+    bool highResolution_{false};
+    // Max count of events taken by one wait, 0 means growing with listened file descriptors.
+    std::atomic<uint32_t> maxEventsPerWait_{0};
+    std::atomic<size_t> fileDescriptorCount_{0};
+    // Count of threads in 'WaitFor' in low 32 bits, and generation of grace period in high 32 bits,
+    // which increases whenever the count drops to zero.
+    std::atomic<uint64_t> waiterState_{0};
+    // Removed records with the generation when they are removed, guarded by 'fileDescriptorMapLock'.
+    std::vector<std::pair<uint32_t, std::shared_ptr<FileDescriptorInfo>>> retired_;
+    std::atomic<bool> hasRetired_{false};
     std::mutex fileDescriptorMapLock;
     FileDescriptorEventCallback callback_;
     std::atomic<int32_t> waitingCount_{0};
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_EVENT_INDEX_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_EVENT_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "inner_event.h"
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+// Which container of event queue holds the event.
+enum class EventLocation : uint8_t {
+    NONE = 0,
+    SORTED_QUEUE,
+    TIMING_WHEEL,
+    // Picked by the runner in a batch, but not distributed yet.
+    PICKED,
+};
+
+/*
+ * Indexes of queued events by owner, by owner and event id, and by owner and task name.
+ *
+ * Events are linked into the indexes through intrusive links, so adding and erasing an event is O(1),
+ * and looking up events costs in proportion to the matched events, instead of the length of event queue.
+ * Events found by indexes are discarded in place: they are left in their queues as tombstones with payload
+ * moved out, and dropped when the queues meet them.
+ * All methods MUST be called with the lock of event queue held.
+ */
+class EventIndex final {
+public:
+    EventIndex() = default;
+    ~EventIndex() = default;
+    DISALLOW_COPY_AND_MOVE(EventIndex);
+
+    /**
+     * Add an event into indexes, while it is inserted into event queue.
+     * Events without owner id are not indexed.
+     *
+     * @param event The inserted event.
+     */
+    LOCAL_API void Add(InnerEvent &event);
+
+    /**
+     * Erase an event from indexes, while it is taken out of event queue. Do nothing if not indexed.
+     *
+     * @param event The event taken out.
+     */
+    LOCAL_API void Erase(InnerEvent &event);
+
+    /**
+     * Erase an event from indexes and mark it discarded, the event is still kept by its queue.
+     *
+     * @param event The discarded event.
+     * @return Returns an event holding task callback, smart pointer and waiter of the discarded event,
+     * so that they could be released out of the lock of event queue.
+     */
+    LOCAL_API InnerEvent::Pointer Discard(InnerEvent &event);
+
+    /**
+     * Remove all events from indexes.
+     */
+    LOCAL_API void Clear();
+
+    /**
+     * Find the chain of events by owner, by owner and event id, or by owner and task name.
+     *
+     * @return Returns the head of chain, or nullptr if not found.
+     */
+    LOCAL_API const EventIndexLink *FindOwner(uint64_t ownerId) const;
+    LOCAL_API const EventIndexLink *FindEventId(uint64_t ownerId, uint32_t innerEventId) const;
+    LOCAL_API const EventIndexLink *FindTaskName(uint64_t ownerId, const std::string &name) const;
+
+    /**
+     * Visit events in a chain in order of insertion, until the visitor returns true.
+     *
+     * @param chain Head of chain, could be nullptr.
+     * @param visitor Visitor of events, MUST NOT add or erase events.
+     * @return Returns true if the visitor returns true.
+     */
+    template<typename Visitor>
+    static bool Visit(const EventIndexLink *chain, Visitor &&visitor)
+    {
+        if (chain == nullptr) {
+            return false;
+        }
+        for (const EventIndexLink *link = chain->next; link != chain; link = link->next) {
+            if (visitor(*link->event)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static inline bool IsDiscarded(const InnerEvent &event)
+    {
+        return event.isDiscarded_;
+    }
+
+    static inline EventLocation GetLocation(const InnerEvent &event)
+    {
+        return static_cast<EventLocation>(event.queueLocation_);
+    }
+
+    static inline void SetLocation(InnerEvent &event, EventLocation location)
+    {
+        event.queueLocation_ = static_cast<uint8_t>(location);
+    }
+
+private:
+    struct OwnerEntry {
+        EventIndexLink events;
+        std::unordered_map<uint32_t, EventIndexLink> eventIds;
+        std::unordered_map<std::string, EventIndexLink> taskNames;
+    };
+
+    static void LinkBack(EventIndexLink &head, EventIndexLink &link, InnerEvent *event);
+    // Returns true if the chain becomes empty.
+    static bool Unlink(EventIndexLink &link);
+
+    std::unordered_map<uint64_t, OwnerEntry> owners_;
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_EVENT_INDEX_H
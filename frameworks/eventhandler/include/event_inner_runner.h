@@ -61,6 +61,11 @@ public:
         return kernelThreadId_;
     }
 
+    LOCAL_API ErrCode GetThreadAttributesResult()
+    {
+        return threadAttributesResult_.load();
+    }
+
 protected:
     std::shared_ptr<EventQueue> queue_;
     std::weak_ptr<EventRunner> owner_;
@@ -71,6 +76,8 @@ protected:
     int64_t kernelThreadId_{0};
     Mode runningMode_ = Mode::DEFAULT;
     bool mainRunnerFlag_{false};
+    // The first error while applying thread attributes.
+    std::atomic<ErrCode> threadAttributesResult_{ERR_OK};
 };
 }  // namespace AppExecFwk
 }  // namespace OHOS
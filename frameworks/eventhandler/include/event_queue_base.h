@@ -19,9 +19,16 @@
 #include <array>
 #include <list>
 #include <map>
+#include <memory>
 #include <mutex>
+#include <unordered_set>
+#include <vector>
 
+#include "event_index.h"
 #include "event_queue.h"
+#include "ingress_queue.h"
+#include "sorted_event_queue.h"
+#include "timing_wheel.h"
 
 #define LOCAL_API __attribute__((visibility ("hidden")))
 namespace OHOS {
@@ -29,6 +36,7 @@ namespace AppExecFwk {
 class IoWaiter;
 class EventHandler;
 class DeamonIoWaiter;
+class StealingGroup;
 
 struct CurrentRunningEvent {
     InnerEvent::TimePoint beginTime_;
@@ -40,7 +48,8 @@ struct CurrentRunningEvent {
     int64_t param_{0};
     bool hasTask_{false};
     std::string taskName_;
-    std::string callerInfo_;
+    // Formatted only while dumping.
+    Caller caller_ {"", 0, ""};
     InnerEvent::EventId innerEventId_ = 0u;
     CurrentRunningEvent();
     CurrentRunningEvent(InnerEvent::TimePoint time, InnerEvent::Pointer &event);
@@ -70,6 +79,15 @@ public:
         EventInsertType insertType = EventInsertType::AT_END,
         VsyncBarrierOption option = VsyncBarrierOption::NO_BARRIER) override;
 
+    /**
+     * Insert a batch of events at end of event queue, with the priority set in each event.
+     * The lock is held only once for the whole batch, and the runner is woken up at most once.
+     *
+     * @param events Events which should be added into event queue, inserted events are moved out.
+     * @return Returns true if all events are inserted.
+     */
+    bool InsertBatch(std::vector<InnerEvent::Pointer> &events) override;
+
     /**
      * Remove events if its owner is invalid.
      */
@@ -283,9 +301,123 @@ public:
      * @param usable current usable.
      */
     void SetUsable(bool usable);
+
+    /**
+     * Keep delayed events in a hierarchical timing wheel, until they are about to expire.
+     * It is suitable for lots of delayed events which are mostly removed before expiration, such as timeouts.
+     */
+    void EnableTimingWheel();
+
+    /**
+     * Let events posted to the end of queue wait in a lock free ingress queue, until the runner takes them in.
+     * Posting threads do not contend the lock of event queue with the runner then.
+     * MUST be called before any event is inserted, usually while the runner is created.
+     */
+    void EnableIngressQueue();
+
+    /**
+     * Let the runner pick several ready events by one scan of sub event queues, instead of one event per scan.
+     * Picked events are still found by removing and querying, and they are put back into sub event queues
+     * if an event which should be distributed before them is inserted.
+     * Not used by worker pool and stealing group.
+     *
+     * @param maxCount Max count of events picked at a time, 1 means one by one.
+     */
+    void SetPickBatchSize(uint32_t maxCount);
+
+    /**
+     * Let several worker threads take events from this queue, see {@link ThreadMode::POOL}.
+     * Events of a handler are never taken while another event of it is being distributed, and a worker
+     * which takes an event wakes up another one, if more events could be distributed.
+     * MUST be called before workers start.
+     */
+    void EnableWorkerPool();
+
+    /**
+     * Let events of a handler be taken again, after a worker of pool distributes its event.
+     *
+     * @param ownerId Numeric id of the handler, 0 means no owner.
+     */
+    void FinishDistribution(uint64_t ownerId);
+
+    /**
+     * Let the runner steal ready events from its peers in a group while it has nothing to do, and let its peers
+     * steal ready tasks of LOW and IDLE priority from this queue, except those marked thread affine.
+     *
+     * MUST be called before any event is inserted, usually while the group is created.
+     *
+     * @param group Group of queues, which is not kept alive by this queue.
+     * @param index Index of this queue in the group.
+     */
+    void JoinStealingGroup(const std::shared_ptr<StealingGroup> &group, uint32_t index);
+
+    /**
+     * Take a ready task which could be stolen by a peer in stealing group, called by the thread of the peer.
+     *
+     * @return Returns the task, or nullptr if none could be stolen.
+     */
+    InnerEvent::Pointer StealEvent();
+
+    /**
+     * Wake up the runner if it is sleeping, to steal events from its peers.
+     *
+     * @return Returns true if the runner is woken up.
+     */
+    bool WakeUpForStealing();
+
+    /**
+     * Get the count of events waiting in this queue.
+     *
+     * @return Returns the count of events.
+     */
+    size_t GetQueuedEventCount();
+
+    /**
+     * Remove all events of a handler, which is finishing.
+     *
+     * @param ownerId Numeric id of the handler.
+     */
+    void RemoveOrphanByOwnerId(uint64_t ownerId) override;
+
+    /**
+     * Wait for the next event with precision of nanoseconds, instead of milliseconds,
+     * while listening file descriptors.
+     */
+    void EnableHighResolutionWait();
+
+    /**
+     * Set max count of events taken from epoll by one wait, instead of growing with listened file descriptors.
+     *
+     * @param maxEvents Max count of events, 0 means growing with listened file descriptors.
+     */
+    void SetMaxEventsPerWait(uint32_t maxEvents);
+
+    /**
+     * Get counts of wakeups issued to the sleeping runner thread, and wakeups elided since it was awake.
+     *
+     * @param issuedCount Output count of issued wakeups.
+     * @param elidedCount Output count of elided wakeups.
+     */
+    void GetWakeupCounts(uint64_t &issuedCount, uint64_t &elidedCount) const;
+
+    /**
+     * Spin for new events for a while before sleeping, which trades CPU time for latency of wakeup.
+     *
+     * @param busyPollTime Max time of spinning each time the runner thread has nothing to do, 0 means never.
+     */
+    void SetBusyPollTime(std::chrono::nanoseconds busyPollTime);
+
+    /**
+     * Get counts of busy polls which take new events, and which end up sleeping.
+     *
+     * @param hitCount Output count of busy polls which take new events.
+     * @param parkCount Output count of busy polls which end up sleeping.
+     */
+    void GetBusyPollCounts(uint64_t &hitCount, uint64_t &parkCount) const;
 private:
     using RemoveFilter = std::function<bool(const InnerEvent::Pointer &)>;
-    using HasFilter = std::function<bool(const InnerEvent::Pointer &)>;
+    using IndexFinder = std::function<const EventIndexLink *(const EventIndex &)>;
+    using IndexFilter = std::function<bool(InnerEvent &)>;
 
     /**
      * Confirm whether it can enter barrier mode
@@ -307,7 +439,7 @@ private:
         InnerEvent::TimePoint triggerTime;
         InnerEvent::TimePoint completeTime;
         int32_t priority = -1;
-        std::string callerInfo_;
+        Caller caller_ {"", 0, ""};
     };
 
     /*
@@ -319,30 +451,142 @@ private:
     // Sub event queues for IMMEDIATE, HIGH and LOW priority. So use value of IDLE as size.
     static const uint32_t SUB_EVENT_QUEUE_NUM = static_cast<uint32_t>(Priority::IDLE);
 
+    // Counts of continuously handled events of sub event queues.
+    using HandledCounts = std::array<uint32_t, SUB_EVENT_QUEUE_NUM>;
+
     struct SubEventQueue {
-        std::list<InnerEvent::Pointer> queue;
+        SortedEventQueue queue;
         uint32_t handledEventsCount{0};
         uint32_t maxHandledEventsCount{DEFAULT_MAX_HANDLED_EVENT_COUNT};
         uint64_t frontEventHandleTime = UINT64_MAX;
     };
 
-    LOCAL_API void Remove(const RemoveFilter &filter);
+    inline void DrainIngressLocked()
+    {
+        if (ingressQueue_ && !ingressQueue_->Empty()) {
+            DrainIngressSlowLocked();
+        }
+    }
+
+    // File descriptor event whose listener is called by the running loop directly.
+    struct DirectFileDescriptorEvent {
+        int32_t fileDescriptor;
+        uint32_t events;
+        Priority priority;
+        std::weak_ptr<FileDescriptorListener> listener;
+    };
+
+    bool PushDirectFileDescriptorEvent(int32_t fileDescriptor, uint32_t events, Priority priority,
+        const std::shared_ptr<FileDescriptorListener> &listener) override;
+    bool CoalesceFileDescriptorEvent(int32_t fileDescriptor, uint32_t events) override;
+    uint32_t TakeCoalescedFileDescriptorEvents(int32_t fileDescriptor, uint32_t events) override;
+    bool IsWorkerPool() const override;
+    LOCAL_API void PruneCoalescedFileDescriptorEventsLocked();
+    LOCAL_API void ApplyWaitOptionsLocked();
+    LOCAL_API void SleepUntilLocked(const InnerEvent::TimePoint &when, UniqueLockBase &lock);
+    LOCAL_API void NotifyOneLocked();
+    LOCAL_API bool DispatchDirectFileDescriptorEventsLocked(UniqueLockBase &lock);
+    LOCAL_API bool HasExpiredEventLocked(Priority priority, const InnerEvent::TimePoint &now) const;
+    LOCAL_API void DrainIngressSlowLocked();
+    LOCAL_API bool PushIngress(InnerEvent::Pointer &event, Priority priority);
+    LOCAL_API bool PushIngressBatch(std::vector<InnerEvent::Pointer> &events);
+    LOCAL_API void WakeUpIngressWaiter();
+    LOCAL_API bool InsertBatchLocked(std::vector<InnerEvent::Pointer> &events, bool &needNotify);
+    LOCAL_API bool Remove(const IndexFinder &finder, const IndexFilter &filter);
+    LOCAL_API bool DiscardEventsLocked(const EventIndexLink *chain, const IndexFilter &filter,
+        std::list<InnerEvent::Pointer> &releaseEvents);
     LOCAL_API void RemoveOrphan(const RemoveFilter &filter);
-    LOCAL_API bool HasInnerEvent(const HasFilter &filter);
+    LOCAL_API bool HasInnerEvent(const IndexFinder &finder, const IndexFilter &filter);
     LOCAL_API InnerEvent::Pointer PickFirstVsyncEventLocked();
     LOCAL_API InnerEvent::Pointer PickEventLocked(const InnerEvent::TimePoint &now,
         InnerEvent::TimePoint &nextWakeUpTime);
+    LOCAL_API InnerEvent::Pointer PickPooledEventLocked(const InnerEvent::TimePoint &now,
+        InnerEvent::TimePoint &nextWakeUpTime);
+    LOCAL_API bool HasPooledEventLocked(const InnerEvent::TimePoint &now);
+    LOCAL_API bool IsStealableOnInsert(const InnerEvent::Pointer &event, Priority priority) const;
+    LOCAL_API InnerEvent::Pointer PopStealableEventLocked(const InnerEvent::TimePoint &now);
+    LOCAL_API bool HasStealableEventLocked(const InnerEvent::TimePoint &now);
+    LOCAL_API InnerEvent::Pointer StealFromPeers(const std::shared_ptr<StealingGroup> &group, UniqueLockBase &lock);
+    LOCAL_API bool BusyPollLocked(const InnerEvent::TimePoint &nextWakeUpTime, UniqueLockBase &lock);
+    LOCAL_API void PickBatchLocked(const InnerEvent::TimePoint &now);
+    LOCAL_API InnerEvent::Pointer TakePickedEventLocked();
+    LOCAL_API void ReturnPickedEventsLocked();
+    LOCAL_API void RestoreHandledCountsLocked(const HandledCounts &handledCounts);
+    LOCAL_API void CheckPickedEventsOnInsertLocked(const InnerEvent::Pointer &event, uint32_t priority,
+        EventInsertType insertType);
     LOCAL_API InnerEvent::Pointer GetExpiredEventLocked(InnerEvent::TimePoint &nextExpiredTime);
+    LOCAL_API void MoveExpiredTimersLocked(const InnerEvent::TimePoint &now);
+    LOCAL_API bool IsSubEventQueueEmptyLocked(uint32_t priority) const;
     LOCAL_API std::string HistoryQueueDump(const HistoryEvent &historyEvent);
     LOCAL_API std::string DumpCurrentRunning();
     LOCAL_API void DumpCurrentRunningEventId(const InnerEvent::EventId &innerEventId, std::string &content);
     LOCAL_API void DumpCurentQueueInfo(Dumper &dumper, uint32_t dumpMaxSize);
 
+    // Concrete type of 'queueLock_', so that hot paths could lock it without virtual dispatch.
+    EventLockType lockType_ {EventLockType::STANDARD};
+
+    // Whether IO waiter should time out with precision of nanoseconds.
+    bool highResolutionWait_ {false};
+    // Max count of events taken from epoll by one wait, 0 means growing with listened file descriptors.
+    uint32_t maxEventsPerWait_ {0};
+    // Whether several worker threads take events from this queue, set before they start.
+    bool workerPool_ {false};
+
+    // Count of threads sleeping in 'SleepUntilLocked', and whether they have been woken up, guarded by 'queueLock_'.
+    int32_t sleepingCount_ {0};
+    bool wakeupPending_ {false};
+    std::atomic<uint64_t> issuedWakeupCount_ {0};
+    std::atomic<uint64_t> elidedWakeupCount_ {0};
+
+    // Max time of busy poll before sleeping, 0 means never.
+    std::chrono::nanoseconds busyPollTime_ {0};
+    // Whether the runner thread is busy polling, guarded by 'queueLock_', and whether it is woken up while polling.
+    bool busyPolling_ {false};
+    std::atomic<bool> busyPollWoken_ {false};
+    std::atomic<uint64_t> busyPollHitCount_ {0};
+    std::atomic<uint64_t> busyPollParkCount_ {0};
+
+    // Pending call of listeners with FILE_DESCRIPTOR_COALESCED, and events merged into it.
+    struct CoalescedFileDescriptorEvent {
+        uint32_t events {0};
+        bool pending {false};
+        int32_t coalescedCount {0};
+    };
+    std::map<int32_t, CoalescedFileDescriptorEvent> coalescedFileDescriptorEvents_;
+
     // Sub event queues for different priority.
     std::array<SubEventQueue, SUB_EVENT_QUEUE_NUM> subEventQueues_;
 
     // Event queue for IDLE events.
-    std::list<InnerEvent::Pointer> idleEvents_;
+    SortedEventQueue idleEvents_;
+
+    // Delayed events of sub event queues, only used if enabled.
+    std::unique_ptr<TimingWheel> timingWheel_;
+
+    // Events posted without the lock, taken in before the queue is accessed, only used if enabled.
+    std::unique_ptr<IngressQueue> ingressQueue_;
+
+    // File descriptor events waiting for the running loop to call their listeners.
+    std::vector<DirectFileDescriptorEvent> directFileDescriptorEvents_;
+
+    // Handlers whose events are being distributed by workers of pool.
+    std::unordered_set<uint64_t> busyHandlers_;
+
+    // Group whose runners steal events from each other, and index of this queue in it.
+    std::weak_ptr<StealingGroup> stealingGroup_;
+    uint32_t stealingIndex_ {0};
+
+    // Events picked in a batch, taken one by one from 'pickedIndex_', and the lowest priority among them.
+    // Counts of continuously handled events before picking each of them are kept to put them back.
+    std::vector<InnerEvent::Pointer> pickedEvents_;
+    std::vector<HandledCounts> pickedHandledCounts_;
+    size_t pickedIndex_ {0};
+    uint32_t pickedPriorityBound_ {0};
+    // Max count of events picked at a time, 1 means one by one.
+    uint32_t pickBatchSize_ {1};
+
+    // Indexes of queued events, to find events of a handler without scanning all the queues.
+    EventIndex eventIndex_;
 
     // Next wake up time when block in 'GetEvent'.
     InnerEvent::TimePoint wakeUpTime_ { InnerEvent::TimePoint::max() };
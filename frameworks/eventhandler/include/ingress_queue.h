@@ -0,0 +1,96 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_INGRESS_QUEUE_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_INGRESS_QUEUE_H
+
+#include <atomic>
+#include <vector>
+
+#include "inner_event.h"
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+/*
+ * Lock free multi-producer single-consumer queue, where posted events wait until the event queue takes them in.
+ *
+ * Producers push events without the lock of event queue, by a single compare-and-swap on an intrusive stack.
+ * The consumer, holding the lock of event queue, takes all events at once and restores the order of pushing,
+ * so events pushed by the same thread are always taken in order.
+ * To wake up the consumer, it announces waiting before blocking, and the producer who sees the announcement
+ * is responsible to notify it.
+ */
+class IngressQueue final {
+public:
+    IngressQueue() = default;
+    ~IngressQueue();
+    DISALLOW_COPY_AND_MOVE(IngressQueue);
+
+    /**
+     * Push an event, called by any thread.
+     *
+     * @param event Event instance which should be pushed, it is moved out.
+     * @return Returns true if the consumer is waiting, the caller MUST wake it up then.
+     */
+    LOCAL_API bool Push(InnerEvent::Pointer &event);
+
+    /**
+     * Push events in order with a single compare-and-swap, called by any thread.
+     *
+     * @param events Valid events which should be pushed, they are moved out.
+     * @return Returns true if the consumer is waiting, the caller MUST wake it up then.
+     */
+    LOCAL_API bool PushBatch(std::vector<InnerEvent::Pointer> &events);
+
+    /**
+     * Take all events in order of pushing, only called by the consumer.
+     *
+     * @param events Output events, which are appended.
+     */
+    LOCAL_API void PopAll(std::vector<InnerEvent::Pointer> &events);
+
+    /**
+     * Announce that the consumer is going to wait.
+     *
+     * @return Returns false if there are events pushed, the consumer should take them instead of waiting.
+     */
+    LOCAL_API bool PrepareWait();
+
+    /**
+     * Withdraw the announcement of waiting, after the consumer is woken up.
+     */
+    inline void FinishWait()
+    {
+        waiting_.store(false, std::memory_order_relaxed);
+    }
+
+    inline bool Empty() const
+    {
+        return head_.load(std::memory_order_acquire) == nullptr;
+    }
+
+private:
+    LOCAL_API bool PushChain(InnerEvent *first, InnerEvent *last);
+    LOCAL_API bool CheckWaiting();
+
+    // Top of stack, which is the event pushed last.
+    std::atomic<InnerEvent *> head_ {nullptr};
+    std::atomic<bool> waiting_ {false};
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_INGRESS_QUEUE_H
@@ -39,13 +39,18 @@ public:
     std::string taskName_;
     EventQueue::Priority priority_;
     std::shared_ptr<FileDescriptorListener> listener_;
+    // Events registered into epoll, used to listen again.
+    uint32_t epollEvents_ {0};
+    // Modes of listening, such as FILE_DESCRIPTOR_ONESHOT, which are reported together with events.
+    uint32_t modes_ {0};
+    int32_t fileDescriptor_ {-1};
 };
 
 // Interface of IO waiter
 class IoWaiter {
 public:
     using FileDescriptorEventCallback = std::function<void(int32_t, uint32_t, const std::string&,
-        EventQueue::Priority priority)>;
+        EventQueue::Priority priority, const std::shared_ptr<FileDescriptorListener>&)>;
 
     IoWaiter() = default;
     virtual ~IoWaiter() = default;
@@ -104,6 +109,29 @@ public:
 
     LOCAL_API virtual std::shared_ptr<FileDescriptorInfo> GetFileDescriptorMap(int32_t fileDescriptor)
         { return nullptr; }
+
+    /**
+     * Wait with precision of nanoseconds, if the waiter rounds time out to milliseconds by default.
+     */
+    LOCAL_API virtual void EnableHighResolution() {}
+
+    /**
+     * Set max count of events taken by one wait.
+     *
+     * @param maxEvents Max count of events, 0 means growing with listened file descriptors.
+     */
+    LOCAL_API virtual void SetMaxEventsPerWait(uint32_t maxEvents) {}
+
+    /**
+     * Listen file descriptor again, which is listened in one-shot mode.
+     *
+     * @param fileDescriptor File descriptor which need to listen again.
+     * @return True if succeeded.
+     */
+    LOCAL_API virtual bool RearmFileDescriptor(int32_t fileDescriptor)
+    {
+        return false;
+    }
 };
 }  // namespace AppExecFwk
 }  // namespace OHOS
@@ -48,6 +48,8 @@ public:
 private:
     std::condition_variable condition_;
     bool pred_ {false};
+    // Increased by 'NotifyAll', so that no waiter misses it even if another one has reset 'pred_'.
+    uint64_t generation_ {0};
     std::mutex waitLock_;
 };
 }  // namespace AppExecFwk
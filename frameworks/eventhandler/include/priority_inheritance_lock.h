@@ -22,7 +22,7 @@
 namespace OHOS {
 namespace AppExecFwk {
 
-class PriorityInheritanceLock : public LockBase {
+class PriorityInheritanceLock final : public LockBase {
 public:
     PriorityInheritanceLock()
     {
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_QUEUE_LOCK_GUARD_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_QUEUE_LOCK_GUARD_H
+
+#include "adaptive_lock.h"
+#include "lock_base.h"
+#include "nocopyable.h"
+#include "priority_inheritance_lock.h"
+#include "std_lock.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+template<EventLockType type>
+struct LockTypeOf {
+    using Type = StdLock;
+};
+
+template<>
+struct LockTypeOf<EventLockType::PRIORITY_INHERIT> {
+    using Type = PriorityInheritanceLock;
+};
+
+template<>
+struct LockTypeOf<EventLockType::ADAPTIVE> {
+    using Type = AdaptiveLock;
+};
+
+template<>
+struct LockTypeOf<EventLockType::ADAPTIVE_PRIORITY_INHERIT> {
+    using Type = AdaptivePriorityInheritanceLock;
+};
+
+/*
+ * Lock guard of event queue, which locks through the concrete type of lock instead of virtual functions.
+ *
+ * All lock types are final, so locking and unlocking are inlined into hot paths after a switch on lock type,
+ * which is well predicted since it never changes for a queue.
+ */
+class QueueLockGuard final {
+public:
+    QueueLockGuard(EventLockType type, LockBase &lock) : type_(type), lock_(lock)
+    {
+        Dispatch<true>();
+    }
+
+    ~QueueLockGuard()
+    {
+        Dispatch<false>();
+    }
+
+    DISALLOW_COPY_AND_MOVE(QueueLockGuard);
+
+private:
+    template<EventLockType type, bool acquire>
+    inline void Apply()
+    {
+        auto &lock = static_cast<typename LockTypeOf<type>::Type &>(lock_);
+        if constexpr (acquire) {
+            lock.lock();
+        } else {
+            lock.unlock();
+        }
+    }
+
+    template<bool acquire>
+    inline void Dispatch()
+    {
+        switch (type_) {
+            case EventLockType::PRIORITY_INHERIT:
+                Apply<EventLockType::PRIORITY_INHERIT, acquire>();
+                break;
+            case EventLockType::ADAPTIVE:
+                Apply<EventLockType::ADAPTIVE, acquire>();
+                break;
+            case EventLockType::ADAPTIVE_PRIORITY_INHERIT:
+                Apply<EventLockType::ADAPTIVE_PRIORITY_INHERIT, acquire>();
+                break;
+            case EventLockType::STANDARD:
+            default:
+                Apply<EventLockType::STANDARD, acquire>();
+                break;
+        }
+    }
+
+    const EventLockType type_;
+    LockBase &lock_;
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_QUEUE_LOCK_GUARD_H
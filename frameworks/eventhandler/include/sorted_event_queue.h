@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_SORTED_EVENT_QUEUE_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_SORTED_EVENT_QUEUE_H
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "event_index.h"
+#include "event_queue.h"
+#include "inner_event.h"
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+/*
+ * Events sorted by handle time, events with the same handle time are kept in order of insertion.
+ *
+ * Events sent without delay are appended to a FIFO lane in O(1), delayed events are kept in a min-heap,
+ * so that inserting does not need to walk through thousands of pending timeouts.
+ * Events discarded by EventIndex are skipped, and dropped once they reach the front of their lane.
+ * All methods MUST be called with the lock of event queue held.
+ */
+class SortedEventQueue final {
+public:
+    using Filter = std::function<bool(const InnerEvent::Pointer &)>;
+
+    SortedEventQueue() = default;
+    ~SortedEventQueue() = default;
+    SortedEventQueue(SortedEventQueue &&) = default;
+    SortedEventQueue &operator=(SortedEventQueue &&) = default;
+    DISALLOW_COPY(SortedEventQueue);
+
+    /**
+     * Insert an event, sorted by its handle time.
+     *
+     * @param event Event instance which should be added into queue.
+     * @param insertType The type of inserting event to queue.
+     */
+    LOCAL_API void Insert(InnerEvent::Pointer &event, EventInsertType insertType = EventInsertType::AT_END);
+
+    /**
+     * Insert a batch of events at end of queue, in order of the batch for events with the same handle time.
+     * Delayed events are pushed into heap together, which is cheaper than inserting them one by one.
+     *
+     * @param events Events which should be added into queue, all of them are moved out.
+     */
+    LOCAL_API void InsertBatch(std::vector<InnerEvent::Pointer> &events);
+
+    /**
+     * Get the event with the earliest handle time. Make sure the queue is not empty.
+     *
+     * @return Returns the first event.
+     */
+    LOCAL_API const InnerEvent::Pointer &Front() const;
+
+    /**
+     * Remove and return the event with the earliest handle time. Make sure the queue is not empty.
+     *
+     * @return Returns the first event.
+     */
+    LOCAL_API InnerEvent::Pointer PopFront();
+
+    /**
+     * Remove and return the first event matched by filter, in order of handle time.
+     *
+     * @param filter Filter of events.
+     * @return Returns the matched event, or nullptr if not found.
+     */
+    LOCAL_API InnerEvent::Pointer PopFirst(const Filter &filter);
+
+    /**
+     * Check whether any event is matched by filter.
+     *
+     * @param filter Filter of events.
+     * @return Returns true if found.
+     */
+    LOCAL_API bool HasIf(const Filter &filter) const;
+
+    /**
+     * Remove and destroy all events matched by filter.
+     *
+     * @param filter Filter of events.
+     */
+    LOCAL_API void RemoveIf(const Filter &filter);
+
+    /**
+     * Move all events matched by filter into another list, so that they can be destroyed later.
+     *
+     * @param filter Filter of events.
+     * @param events Output the removed events.
+     */
+    LOCAL_API void MoveIf(const Filter &filter, std::list<InnerEvent::Pointer> &events);
+
+    /**
+     * Remove all events.
+     */
+    LOCAL_API void Clear();
+
+    /**
+     * Count an event in this queue which has been discarded by EventIndex, it is dropped lazily.
+     */
+    LOCAL_API void MarkDiscarded();
+
+    inline bool Empty() const
+    {
+        // Discarded events never stay at the front of lanes, so a non-empty lane always has a valid event.
+        return fifoEvents_.empty() && delayedEvents_.empty();
+    }
+
+    inline size_t Size() const
+    {
+        return fifoEvents_.size() + delayedEvents_.size() - discardedCount_;
+    }
+
+    /**
+     * Visit all events in order of handle time, only used for dumping.
+     *
+     * @param visitor Visitor of events.
+     */
+    template<typename Visitor>
+    void ForEach(Visitor &&visitor) const
+    {
+        std::vector<const Node *> delayed;
+        delayed.reserve(delayedEvents_.size());
+        for (const auto &node : delayedEvents_) {
+            if (!EventIndex::IsDiscarded(*node.event)) {
+                delayed.emplace_back(&node);
+            }
+        }
+        std::sort(delayed.begin(), delayed.end(), [](const Node *a, const Node *b) { return Before(*a, *b); });
+
+        auto fifoIt = fifoEvents_.begin();
+        auto delayedIt = delayed.begin();
+        while ((fifoIt != fifoEvents_.end()) || (delayedIt != delayed.end())) {
+            if ((delayedIt == delayed.end()) || ((fifoIt != fifoEvents_.end()) && !Before(**delayedIt, *fifoIt))) {
+                if (!EventIndex::IsDiscarded(*fifoIt->event)) {
+                    visitor(fifoIt->event);
+                }
+                ++fifoIt;
+            } else {
+                visitor((*delayedIt)->event);
+                ++delayedIt;
+            }
+        }
+    }
+
+private:
+    struct Node {
+        InnerEvent::TimePoint handleTime;
+        // Order of insertion, events inserted at front use negative sequence.
+        int64_t sequence;
+        InnerEvent::Pointer event;
+    };
+
+    static inline bool Before(const Node &a, const Node &b)
+    {
+        return (a.handleTime < b.handleTime) || ((a.handleTime == b.handleTime) && (a.sequence < b.sequence));
+    }
+
+    static inline bool After(const Node &a, const Node &b)
+    {
+        return Before(b, a);
+    }
+
+    // Drop discarded events at the front of lanes.
+    void PurgeFront();
+
+    inline bool FrontIsDelayed() const
+    {
+        return fifoEvents_.empty() || (!delayedEvents_.empty() && Before(delayedEvents_.front(), fifoEvents_.front()));
+    }
+
+    // Events sent without delay, sorted by handle time.
+    std::deque<Node> fifoEvents_;
+    // Min-heap of delayed events.
+    std::vector<Node> delayedEvents_;
+    int64_t backSequence_ {0};
+    int64_t frontSequence_ {0};
+    // Count of discarded events still in lanes.
+    size_t discardedCount_ {0};
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_SORTED_EVENT_QUEUE_H
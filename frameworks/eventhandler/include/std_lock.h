@@ -22,7 +22,7 @@
 namespace OHOS {
 namespace AppExecFwk {
 
-class StdLock : public LockBase {
+class StdLock final : public LockBase {
 public:
     void lock() override
     {
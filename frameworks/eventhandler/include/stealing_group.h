@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_STEALING_GROUP_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_STEALING_GROUP_H
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "inner_event.h"
+#include "nocopyable.h"
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+class EventQueueBase;
+
+/*
+ * Group of event queues, whose runners steal ready events from busy peers instead of sleeping.
+ *
+ * A runner which has nothing to do announces itself idle before looking for events of peers, and stays idle
+ * until it takes an event. A runner which finds more events could be stolen after picking one wakes up an idle
+ * peer. The count of notifications tells an idle runner to look again, if it is notified between looking and
+ * sleeping. Queues are never locked nested, so a runner calls the group without the lock of its own queue.
+ */
+class StealingGroup final {
+public:
+    explicit StealingGroup(const std::vector<std::shared_ptr<EventQueueBase>> &queues);
+    ~StealingGroup() = default;
+    DISALLOW_COPY_AND_MOVE(StealingGroup);
+
+    /**
+     * Steal a ready event from peers of a runner.
+     *
+     * @param thief Index of the queue whose runner has nothing to do.
+     * @return Returns the stolen event, or nullptr if none could be stolen.
+     */
+    LOCAL_API InnerEvent::Pointer Steal(uint32_t thief);
+
+    /**
+     * Wake up an idle peer, since the queue of a runner has events which could be stolen.
+     *
+     * @param victim Index of the queue.
+     */
+    LOCAL_API void NotifyStealable(uint32_t victim);
+
+    inline void EnterIdle()
+    {
+        idleCount_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    inline void LeaveIdle()
+    {
+        idleCount_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    inline uint64_t GetNotifiedCount() const
+    {
+        return notifiedCount_.load(std::memory_order_seq_cst);
+    }
+
+    inline size_t Size() const
+    {
+        return size_;
+    }
+
+    inline uint64_t GetStolenCount(uint32_t index) const
+    {
+        return members_[index].stolenCount.load(std::memory_order_relaxed);
+    }
+
+    inline uint64_t GetLostCount(uint32_t index) const
+    {
+        return members_[index].lostCount.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Member {
+        std::shared_ptr<EventQueueBase> queue;
+        // Count of events stolen by the runner from its peers.
+        std::atomic<uint64_t> stolenCount {0};
+        // Count of events of the runner stolen by its peers.
+        std::atomic<uint64_t> lostCount {0};
+    };
+
+    size_t size_ {0};
+    std::unique_ptr<Member[]> members_;
+    // Count of runners which are looking for events of peers or sleeping.
+    std::atomic<uint32_t> idleCount_ {0};
+    std::atomic<uint64_t> notifiedCount_ {0};
+};
+
+/*
+ * Announce a runner of stealing group idle, until it is destroyed.
+ */
+class IdleAnnouncement final {
+public:
+    IdleAnnouncement() = default;
+    ~IdleAnnouncement()
+    {
+        Withdraw();
+    }
+    DISALLOW_COPY_AND_MOVE(IdleAnnouncement);
+
+    inline void Announce(const std::shared_ptr<StealingGroup> &group)
+    {
+        if (!group_) {
+            group_ = group;
+            group_->EnterIdle();
+        }
+    }
+
+    inline void Withdraw()
+    {
+        if (group_) {
+            group_->LeaveIdle();
+            group_.reset();
+        }
+    }
+
+private:
+    std::shared_ptr<StealingGroup> group_;
+};
+
+/*
+ * Notify peers of stealing group while destroyed, declare it before the lock guard of queue,
+ * so that peers are notified after the lock is released.
+ */
+class StealableNotification final {
+public:
+    StealableNotification() = default;
+    ~StealableNotification()
+    {
+        if (group_) {
+            group_->NotifyStealable(victim_);
+        }
+    }
+    DISALLOW_COPY_AND_MOVE(StealableNotification);
+
+    inline void Arm(const std::weak_ptr<StealingGroup> &group, uint32_t victim)
+    {
+        group_ = group.lock();
+        victim_ = victim;
+    }
+
+private:
+    std::shared_ptr<StealingGroup> group_;
+    uint32_t victim_ {0};
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_STEALING_GROUP_H
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_THREAD_INFO_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_THREAD_INFO_H
+
+#include <atomic>
+#include <cstdint>
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+/*
+ * Information of current thread, which is read on every post and dispatch.
+ *
+ * It is kept in thread local storage and initialized once for each thread, instead of making syscalls for every event.
+ * The cache of all threads is invalidated in child process after fork, since thread id and process id are changed.
+ */
+class ThreadInfo final {
+public:
+    /**
+     * Get kernel thread id of current thread.
+     *
+     * @return Returns kernel thread id.
+     */
+    static inline int64_t GetKernelThreadId()
+    {
+        return Get().kernelThreadId;
+    }
+
+    /**
+     * Check whether current thread is the main thread of an application process.
+     *
+     * @return Returns true if it is the main thread of an application process.
+     */
+    static inline bool IsAppMainThread()
+    {
+        return Get().isAppMainThread;
+    }
+
+private:
+    struct Info {
+        // Valid only if it is the same as 'generation_'.
+        uint64_t generation {0};
+        int64_t kernelThreadId {0};
+        bool isAppMainThread {false};
+    };
+
+    static inline const Info &Get()
+    {
+        if (__builtin_expect(current_.generation != generation_.load(std::memory_order_relaxed), 0)) {
+            Refresh();
+        }
+        return current_;
+    }
+
+    LOCAL_API static void Refresh();
+
+    static thread_local Info current_;
+    static std::atomic<uint64_t> generation_;
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_THREAD_INFO_H
@@ -16,9 +16,9 @@
 #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_THREAD_LOCAL_DATA_H
 #define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_THREAD_LOCAL_DATA_H
 
-#include <mutex>
-#include <thread>
-#include <unordered_map>
+#include <atomic>
+#include <cstdint>
+#include <vector>
 
 #include "nocopyable.h"
 
@@ -26,11 +26,16 @@ namespace OHOS {
 namespace AppExecFwk {
 /*
  * Tool class, used to save thread local data.
+ *
+ * Data of each thread is kept in native thread local storage, so that accessing it never contends with other threads.
+ * Data saved by a thread is released automatically while the thread exits.
+ * Instances are told apart by unique ids instead of addresses, so an instance created at the address of a destroyed
+ * one never sees its data.
  */
 template<typename T>
 class ThreadLocalData {
 public:
-    ThreadLocalData() = default;
+    ThreadLocalData() : id_(NextId()) {}
     ~ThreadLocalData() = default;
     DISALLOW_COPY_AND_MOVE(ThreadLocalData);
 
@@ -61,31 +66,62 @@ public:
     }
 
 private:
-    inline T Current() const
+    struct Slot {
+        uint64_t id;
+        T data;
+    };
+
+    static uint64_t NextId()
     {
-        std::lock_guard<std::mutex> lock(mapLock_);
-        auto it = dataMap_.find(std::this_thread::get_id());
-        if (it == dataMap_.end()) {
-            return T();
-        } else {
-            return it->second;
+        static std::atomic<uint64_t> nextId {1};
+        return nextId.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Data of all instances for current thread, there are only a few instances, so a vector is enough.
+    static std::vector<Slot> &Slots()
+    {
+        static thread_local std::vector<Slot> slots;
+        return slots;
+    }
+
+    inline T *Find() const
+    {
+        for (auto &slot : Slots()) {
+            if (slot.id == id_) {
+                return &slot.data;
+            }
         }
+        return nullptr;
+    }
+
+    inline T Current() const
+    {
+        T *data = Find();
+        return (data == nullptr) ? T() : *data;
     }
 
     inline void Save(const T &data)
     {
-        std::lock_guard<std::mutex> lock(mapLock_);
-        dataMap_[std::this_thread::get_id()] = data;
+        T *saved = Find();
+        if (saved != nullptr) {
+            *saved = data;
+        } else {
+            Slots().emplace_back(Slot {id_, data});
+        }
     }
 
     inline void Discard()
     {
-        std::lock_guard<std::mutex> lock(mapLock_);
-        (void)dataMap_.erase(std::this_thread::get_id());
+        auto &slots = Slots();
+        for (auto it = slots.begin(); it != slots.end(); ++it) {
+            if (it->id == id_) {
+                slots.erase(it);
+                return;
+            }
+        }
     }
 
-    mutable std::mutex mapLock_;
-    std::unordered_map<std::thread::id, T> dataMap_;
+    const uint64_t id_;
 };
 }  // namespace AppExecFwk
 }  // namespace OHOS
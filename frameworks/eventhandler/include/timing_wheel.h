@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_TIMING_WHEEL_H
+#define BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_TIMING_WHEEL_H
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "event_index.h"
+#include "event_queue.h"
+#include "inner_event.h"
+
+#define LOCAL_API __attribute__((visibility ("hidden")))
+namespace OHOS {
+namespace AppExecFwk {
+/*
+ * Hierarchical timing wheel holding delayed events until their handle time is near.
+ *
+ * Time is divided into ticks of one millisecond. Each level has 64 slots, and a slot of a level covers
+ * a whole rotation of the level below it, so 4 levels cover about 4.6 hours; later events wait in an
+ * overflow list. Inserting and unlinking an event is O(1), and no ordering work is done for events
+ * which are removed before expiration, such as watchdogs and timeouts.
+ * Expired events are handed back to the caller, who is responsible to sort them by exact handle time.
+ * Events discarded by EventIndex are skipped, and dropped while their slots are turned.
+ * All methods MUST be called with the lock of event queue held.
+ */
+class TimingWheel final {
+public:
+    using Filter = std::function<bool(const InnerEvent::Pointer &)>;
+
+    struct Entry {
+        uint64_t tick;
+        uint32_t priority;
+        InnerEvent::Pointer event;
+    };
+
+    explicit TimingWheel(const InnerEvent::TimePoint &now);
+    ~TimingWheel() = default;
+    DISALLOW_COPY_AND_MOVE(TimingWheel);
+
+    /**
+     * Add a delayed event into timing wheel.
+     *
+     * @param event Event instance which should be added into timing wheel.
+     * @param priority Priority of the event, only priorities before IDLE are supported.
+     * @return Returns false if the event is already expired, the event is untouched in that case.
+     */
+    LOCAL_API bool Add(InnerEvent::Pointer &event, uint32_t priority);
+
+    /**
+     * Advance the timing wheel to current time, and output all expired events.
+     *
+     * @param now Current time.
+     * @param expired Output expired events, in order of insertion for events in the same tick.
+     */
+    LOCAL_API void Advance(const InnerEvent::TimePoint &now, std::list<Entry> &expired);
+
+    /**
+     * Get the time to advance the timing wheel next time.
+     *
+     * @return Returns the start time of the earliest tick which holds events, or TimePoint::max() if empty.
+     */
+    LOCAL_API InnerEvent::TimePoint GetNextExpireTime() const;
+
+    LOCAL_API bool HasIf(const Filter &filter) const;
+    LOCAL_API void RemoveIf(const Filter &filter);
+    LOCAL_API void MoveIf(const Filter &filter, std::list<InnerEvent::Pointer> &events);
+    LOCAL_API void Clear();
+
+    /**
+     * Count an event in timing wheel which has been discarded by EventIndex, it is dropped lazily.
+     *
+     * @param priority Priority of the event.
+     */
+    LOCAL_API void MarkDiscarded(uint32_t priority);
+
+    inline bool Empty() const
+    {
+        return size_ == 0;
+    }
+
+    inline size_t Size() const
+    {
+        return size_;
+    }
+
+    inline size_t Size(uint32_t priority) const
+    {
+        return (priority < PRIORITY_NUM) ? counts_[priority] : 0;
+    }
+
+    /**
+     * Visit all events with the specified priority in order of handle time, only used for dumping.
+     *
+     * @param priority Priority of events.
+     * @param visitor Visitor of events.
+     */
+    template<typename Visitor>
+    void ForEach(uint32_t priority, Visitor &&visitor) const
+    {
+        std::vector<const Entry *> entries;
+        entries.reserve(Size(priority));
+        VisitSlots([priority, &entries](const std::list<Entry> &slot) {
+            for (const auto &entry : slot) {
+                if ((entry.priority == priority) && !EventIndex::IsDiscarded(*entry.event)) {
+                    entries.emplace_back(&entry);
+                }
+            }
+            return false;
+        });
+        std::stable_sort(entries.begin(), entries.end(), [](const Entry *a, const Entry *b) {
+            return a->event->GetHandleTime() < b->event->GetHandleTime();
+        });
+        for (const auto *entry : entries) {
+            visitor(entry->event);
+        }
+    }
+
+private:
+    static constexpr uint32_t LEVEL_BITS = 6;
+    static constexpr uint32_t LEVEL_NUM = 4;
+    static constexpr uint32_t SLOT_NUM = 1u << LEVEL_BITS;
+    static constexpr uint64_t SLOT_MASK = SLOT_NUM - 1;
+    static constexpr uint32_t PRIORITY_NUM = static_cast<uint32_t>(EventQueue::Priority::IDLE);
+
+    static uint64_t ToTick(const InnerEvent::TimePoint &time);
+    uint64_t GetNextTick() const;
+    std::list<Entry> &GetSlot(uint64_t tick);
+    void Cascade(std::list<Entry> &slot, std::list<Entry> &expired);
+
+    // Visit all non-empty slots until visitor returns true.
+    template<typename Visitor>
+    bool VisitSlots(Visitor &&visitor) const
+    {
+        for (uint32_t level = 0; level < LEVEL_NUM; ++level) {
+            uint64_t occupied = occupied_[level];
+            while (occupied != 0) {
+                uint32_t index = static_cast<uint32_t>(__builtin_ctzll(occupied));
+                occupied &= occupied - 1;
+                if (visitor(slots_[level][index])) {
+                    return true;
+                }
+            }
+        }
+        return !overflow_.empty() && visitor(overflow_);
+    }
+
+    std::array<std::array<std::list<Entry>, SLOT_NUM>, LEVEL_NUM> slots_;
+    // Bit map of non-empty slots for each level.
+    std::array<uint64_t, LEVEL_NUM> occupied_ {};
+    // Events beyond the range of all levels.
+    std::list<Entry> overflow_;
+    // All events in or before this tick have been handed out.
+    uint64_t currentTick_ {0};
+    size_t size_ {0};
+    std::array<size_t, PRIORITY_NUM> counts_ {};
+    // Count of discarded events still in slots.
+    size_t discardedCount_ {0};
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_FRAMEWORKS_EVENTHANDLER_INCLUDE_TIMING_WHEEL_H
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "adaptive_lock.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "cpu_relax.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+namespace {
+// Upper bound of spinning, the same as adaptive mutex of glibc.
+constexpr int32_t MAX_SPIN_COUNT = 100;
+constexpr int32_t SPIN_COUNT_ADJUST_SHIFT = 3;
+
+inline int32_t GetMaxSpinCount(int32_t spinCount)
+{
+    return CanSpin() ? std::min(MAX_SPIN_COUNT, spinCount * 2 + 10) : 0;
+}
+
+// Spin until 'tryLock' succeeds or the budget runs out, and update the estimated spin count if succeeded.
+template<typename TryLock>
+inline bool SpinLock(std::atomic<int32_t> &spinCount, const TryLock &tryLock)
+{
+    int32_t estimated = spinCount.load(std::memory_order_relaxed);
+    int32_t maxCount = GetMaxSpinCount(estimated);
+    for (int32_t count = 0; count < maxCount; ++count) {
+        CpuRelax();
+        if (tryLock()) {
+            // Lock is held now, so no other thread updates the estimation.
+            spinCount.store(estimated + ((count - estimated) >> SPIN_COUNT_ADJUST_SHIFT), std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+inline long Futex(void *addr, int op, uint32_t val)
+{
+    return syscall(SYS_futex, addr, op, val, nullptr, nullptr, 0);
+}
+}  // unnamed namespace
+
+void AdaptiveLock::LockSlow()
+{
+    bool locked = SpinLock(spinCount_, [this]() {
+        int32_t expected = UNLOCKED;
+        return (state_.load(std::memory_order_relaxed) == UNLOCKED) &&
+            state_.compare_exchange_weak(expected, LOCKED, std::memory_order_acquire, std::memory_order_relaxed);
+    });
+    if (locked) {
+        return;
+    }
+
+    // Mark the lock contended, so that the owner wakes up a sleeping thread while unlocking.
+    while (state_.exchange(CONTENDED, std::memory_order_acquire) != UNLOCKED) {
+        (void)Futex(&state_, FUTEX_WAIT_PRIVATE, static_cast<uint32_t>(CONTENDED));
+    }
+}
+
+void AdaptiveLock::WakeOne()
+{
+    (void)Futex(&state_, FUTEX_WAKE_PRIVATE, 1);
+}
+
+void AdaptivePriorityInheritanceLock::LockSlow()
+{
+    uint32_t ownerId = GetOwnerId();
+    bool locked = SpinLock(spinCount_, [this, ownerId]() {
+        uint32_t expected = 0;
+        return (owner_.load(std::memory_order_relaxed) == 0) &&
+            owner_.compare_exchange_weak(expected, ownerId, std::memory_order_acquire, std::memory_order_relaxed);
+    });
+    if (locked) {
+        return;
+    }
+
+    // Kernel takes the lock for this thread when it is released, and boosts the owner until then.
+    while (Futex(&owner_, FUTEX_LOCK_PI_PRIVATE, 0) != 0) {
+        if ((errno == EINTR) || (errno == EAGAIN)) {
+            continue;
+        }
+        // Priority inheritance futex is not supported, fall back to yielding.
+        uint32_t expected = 0;
+        while (!owner_.compare_exchange_weak(expected, ownerId, std::memory_order_acquire,
+            std::memory_order_relaxed)) {
+            expected = 0;
+            std::this_thread::yield();
+        }
+        return;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+}
+
+void AdaptivePriorityInheritanceLock::UnlockSlow()
+{
+    if (Futex(&owner_, FUTEX_UNLOCK_PI_PRIVATE, 0) != 0) {
+        // Nobody is waiting in kernel, release it directly.
+        owner_.store(0, std::memory_order_release);
+    }
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
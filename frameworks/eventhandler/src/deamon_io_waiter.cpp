@@ -15,9 +15,11 @@
 
 #include "deamon_io_waiter.h"
 
+#include <algorithm>
 #include <chrono>
 
 #include <mutex>
+#include <vector>
 #include <sys/eventfd.h>
 #include <unistd.h>
 
@@ -34,6 +36,8 @@ namespace OHOS {
 namespace AppExecFwk {
 namespace {
 const size_t MAX_EPOLL_EVENTS_SIZE = 8;
+// Upper bound of events taken by one wait, while growing with listened file descriptors.
+const size_t MAX_GROWN_EPOLL_EVENTS_SIZE = 256;
 DEFINE_EH_HILOG_LABEL("DeamonIoWaiter");
 
 inline int32_t EpollCtrl(int32_t epollFd, int32_t operation, int32_t fileDescriptor, uint32_t epollEvents)
@@ -259,13 +263,20 @@ void DeamonIoWaiter::EpollWaitFor()
     ResourceSchedule::ResSchedClient::GetInstance().ReportData(type, value, payload);
     HILOGD("Epoll io waiter set thread sched. pid: %{public}d, tid: %{public}d", getprocpid(), getproctid());
 #endif
+    std::vector<struct epoll_event> epollEvents(MAX_EPOLL_EVENTS_SIZE);
     while (!isFinished_) {
         // Increasment of waiting count MUST be done before unlock.
         ++waitingCount_;
 
+        // Take events of all ready file descriptors by one wait as possible, awaken one is counted in.
+        size_t maxEvents = std::clamp(fileDescriptorCount_.load(std::memory_order_relaxed) + 1,
+            MAX_EPOLL_EVENTS_SIZE, MAX_GROWN_EPOLL_EVENTS_SIZE);
+        if (epollEvents.size() < maxEvents) {
+            epollEvents.resize(maxEvents);
+        }
+
         // Block on epoll_wait outside of the lock.
-        struct epoll_event epollEvents[MAX_EPOLL_EVENTS_SIZE];
-        int32_t retVal = epoll_wait(epollFd_, epollEvents, MAX_EPOLL_EVENTS_SIZE, -1);
+        int32_t retVal = epoll_wait(epollFd_, epollEvents.data(), static_cast<int32_t>(maxEvents), -1);
         // Decrease waiting count after block at once.
         --waitingCount_;
         if (waitingCount_ < 0) {
@@ -279,7 +290,7 @@ void DeamonIoWaiter::EpollWaitFor()
                 HILOGE("Failed to wait epoll, %{public}s", errmsg);
             }
         } else {
-            HandleEpollEvents(epollEvents, retVal);
+            HandleEpollEvents(epollEvents.data(), retVal);
         }
     }
 }
@@ -390,12 +401,14 @@ void DeamonIoWaiter::InsertFileDescriptorMap(int32_t fileDescriptor, const std::
     std::shared_ptr<FileDescriptorInfo> fileDescriptorInfo =
         std::make_shared<FileDescriptorInfo>(taskName, priority, listener);
     fileDescriptorMap_.emplace(fileDescriptor, fileDescriptorInfo);
+    fileDescriptorCount_.store(fileDescriptorMap_.size(), std::memory_order_relaxed);
 }
 
 void DeamonIoWaiter::EraseFileDescriptorMap(int32_t fileDescriptor)
 {
     std::lock_guard<std::mutex> lock(fileDescriptorMapLock);
     fileDescriptorMap_.erase(fileDescriptor);
+    fileDescriptorCount_.store(fileDescriptorMap_.size(), std::memory_order_relaxed);
 }
 
 std::shared_ptr<FileDescriptorInfo> DeamonIoWaiter::GetFileDescriptorMap(int32_t fileDescriptor)
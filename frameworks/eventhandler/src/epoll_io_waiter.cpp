@@ -15,11 +15,16 @@
 
 #include "epoll_io_waiter.h"
 
+#include <algorithm>
 #include <chrono>
+#include <iterator>
 
 #include <mutex>
+#include <vector>
 #include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/timerfd.h>
 #include <unistd.h>
 
 #include "event_handler_utils.h"
@@ -30,17 +35,42 @@ namespace OHOS {
 namespace AppExecFwk {
 namespace {
 const size_t MAX_EPOLL_EVENTS_SIZE = 8;
+// Upper bound of events taken by one wait, while growing with listened file descriptors.
+const size_t MAX_GROWN_EPOLL_EVENTS_SIZE = 256;
+// Awaken and timer file descriptors may be reported together with listened ones.
+const size_t INNER_FILE_DESCRIPTORS_COUNT = 2;
+const uint64_t WAITER_COUNT_MASK = 0xFFFFFFFF;
+const uint32_t GENERATION_SHIFT = 32;
 DEFINE_EH_HILOG_LABEL("EpollIoWaiter");
 
-inline int32_t EpollCtrl(int32_t epollFd, int32_t operation, int32_t fileDescriptor, uint32_t epollEvents)
+inline int32_t EpollCtrl(int32_t epollFd, int32_t operation, int32_t fileDescriptor, uint32_t epollEvents,
+    void *data)
 {
     struct epoll_event epollEvent = {
         .events = epollEvents,
-        .data = {.fd = fileDescriptor},
+        .data = {.ptr = data},
     };
 
     return epoll_ctl(epollFd, operation, fileDescriptor, &epollEvent);
 }
+
+// Whether epoll_pwait2 is supported by kernel, it is probed by the first high resolution wait.
+enum class EpollPwait2Support : int32_t { UNKNOWN = 0, SUPPORTED, UNSUPPORTED };
+std::atomic<EpollPwait2Support> g_epollPwait2Support {EpollPwait2Support::UNKNOWN};
+
+inline int32_t EpollPwait2(int32_t epollFd, struct epoll_event *events, int32_t maxEvents, int64_t nanoseconds)
+{
+#ifdef SYS_epoll_pwait2
+    struct timespec timeout = {
+        .tv_sec = static_cast<time_t>(nanoseconds / NANOSECONDS_PER_ONE_SECOND),
+        .tv_nsec = static_cast<long>(nanoseconds % NANOSECONDS_PER_ONE_SECOND),
+    };
+    return static_cast<int32_t>(syscall(SYS_epoll_pwait2, epollFd, events, maxEvents, &timeout, nullptr, 0));
+#else
+    errno = ENOSYS;
+    return -1;
+#endif
+}
 }  // unnamed namespace
 
 EpollIoWaiter::~EpollIoWaiter()
@@ -56,6 +86,11 @@ EpollIoWaiter::~EpollIoWaiter()
         fdsan_close_with_tag(awakenFd_, EH_LOG_DOMAIN);
         awakenFd_ = -1;
     }
+
+    if (timerFd_ >= 0) {
+        fdsan_close_with_tag(timerFd_, EH_LOG_DOMAIN);
+        timerFd_ = -1;
+    }
 }
 
 bool EpollIoWaiter::Init()
@@ -89,7 +124,7 @@ bool EpollIoWaiter::Init()
         fdsan_exchange_owner_tag(awakenFd, 0, EH_LOG_DOMAIN);
 
         // Add readable file descriptor of pipe, used to wake up blocked thread.
-        if (EpollCtrl(epollFd, EPOLL_CTL_ADD, awakenFd, EPOLLIN | EPOLLET) < 0) {
+        if (EpollCtrl(epollFd, EPOLL_CTL_ADD, awakenFd, EPOLLIN | EPOLLET, &awakenFd_) < 0) {
             char errmsg[MAX_ERRORMSG_LEN] = {0};
             GetLastErr(errmsg, MAX_ERRORMSG_LEN);
             HILOGE("Failed to add awaken file descriptor into epoll, %{public}s", errmsg);
@@ -125,10 +160,18 @@ bool EpollIoWaiter::WaitFor(UniqueLockBase &externLock, int64_t nanoseconds, boo
     // Increasment of waiting count MUST be done before unlock.
     ++waitingCount_;
     externLock.unlock();
+    // Records of ready file descriptors are kept until leaving.
+    EnterWaiting();
+
+    // Take events of all ready file descriptors by one wait as possible, buffer is reused by the thread.
+    size_t maxEvents = GetMaxEventsPerWait();
+    thread_local std::vector<struct epoll_event> epollEvents(MAX_EPOLL_EVENTS_SIZE);
+    if (epollEvents.size() < maxEvents) {
+        epollEvents.resize(maxEvents);
+    }
 
     // Block on epoll_wait outside of the lock.
-    struct epoll_event epollEvents[MAX_EPOLL_EVENTS_SIZE];
-    int32_t retVal = epoll_wait(epollFd_, epollEvents, MAX_EPOLL_EVENTS_SIZE, NanosecondsToTimeout(nanoseconds));
+    int32_t retVal = Wait(epollEvents.data(), static_cast<int32_t>(maxEvents), nanoseconds);
     // Decrease waiting count after block at once.
     --waitingCount_;
     if (waitingCount_ < 0) {
@@ -144,41 +187,217 @@ bool EpollIoWaiter::WaitFor(UniqueLockBase &externLock, int64_t nanoseconds, boo
             result = false;
         }
     } else {
-        for (int32_t i = 0; i < retVal; ++i) {
-            if (epollEvents[i].data.fd == awakenFd_) {
-                // Drain awaken pipe, if woken up by it.
-                DrainAwakenPipe();
-                continue;
-            }
-
-            // Transform epoll events into file descriptor listener events.
-            uint32_t events = 0;
-            if ((epollEvents[i].events & EPOLLIN) != 0) {
-                events |= FILE_DESCRIPTOR_INPUT_EVENT;
-            }
-
-            if ((epollEvents[i].events & EPOLLOUT) != 0) {
-                events |= FILE_DESCRIPTOR_OUTPUT_EVENT;
-            }
-
-            if ((epollEvents[i].events & (EPOLLHUP)) != 0) {
-                events |= FILE_DESCRIPTOR_SHUTDOWN_EVENT;
-            }
-
-            if ((epollEvents[i].events & (EPOLLERR)) != 0) {
-                events |= FILE_DESCRIPTOR_EXCEPTION_EVENT;
-            }
-            auto fdInfo = GetFileDescriptorMap(epollEvents[i].data.fd);
-            if (callback_ && fdInfo != nullptr && (!vsyncOnly || fdInfo->listener_->IsVsyncListener())) {
-                callback_(epollEvents[i].data.fd, events, fdInfo->taskName_, fdInfo->priority_);
-            }
-        }
+        DispatchEvents(epollEvents.data(), retVal, vsyncOnly);
     }
+    LeaveWaiting();
 
     externLock.lock();
     return result;
 }
 
+void EpollIoWaiter::DispatchEvents(struct epoll_event *epollEvents, int32_t count, bool vsyncOnly)
+{
+    for (int32_t i = 0; i < count; ++i) {
+        if (epollEvents[i].data.ptr == &awakenFd_) {
+            // Drain awaken pipe, if woken up by it.
+            DrainAwakenPipe();
+            continue;
+        }
+
+        if (epollEvents[i].data.ptr == &timerFd_) {
+            DrainTimer();
+            continue;
+        }
+
+        auto fdInfo = static_cast<FileDescriptorInfo *>(epollEvents[i].data.ptr);
+        if (fdInfo == nullptr) {
+            continue;
+        }
+
+        // Transform epoll events into file descriptor listener events.
+        uint32_t events = 0;
+        if ((epollEvents[i].events & EPOLLIN) != 0) {
+            events |= FILE_DESCRIPTOR_INPUT_EVENT;
+        }
+
+        if ((epollEvents[i].events & EPOLLOUT) != 0) {
+            events |= FILE_DESCRIPTOR_OUTPUT_EVENT;
+        }
+
+        if ((epollEvents[i].events & (EPOLLHUP)) != 0) {
+            events |= FILE_DESCRIPTOR_SHUTDOWN_EVENT;
+        }
+
+        if ((epollEvents[i].events & (EPOLLERR)) != 0) {
+            events |= FILE_DESCRIPTOR_EXCEPTION_EVENT;
+        }
+
+        events |= fdInfo->modes_;
+        if (callback_ && (!vsyncOnly || fdInfo->listener_->IsVsyncListener())) {
+            callback_(fdInfo->fileDescriptor_, events, fdInfo->taskName_, fdInfo->priority_, fdInfo->listener_);
+        } else if ((fdInfo->epollEvents_ & (EPOLLET | EPOLLONESHOT)) != 0) {
+            // Events are not reported again by themselves, so listen again to get them by the next wait.
+            (void)Rearm(*fdInfo);
+        }
+    }
+}
+
+void EpollIoWaiter::EnterWaiting()
+{
+    waiterState_.fetch_add(1, std::memory_order_seq_cst);
+}
+
+void EpollIoWaiter::LeaveWaiting()
+{
+    // The last leaving thread ends the grace period, records retired before it are never touched again.
+    uint64_t state = waiterState_.load(std::memory_order_relaxed);
+    uint64_t newState = 0;
+    do {
+        if ((state & WAITER_COUNT_MASK) == 1) {
+            newState = (state & ~WAITER_COUNT_MASK) + (1ULL << GENERATION_SHIFT);
+        } else {
+            newState = state - 1;
+        }
+    } while (!waiterState_.compare_exchange_weak(state, newState, std::memory_order_seq_cst,
+        std::memory_order_relaxed));
+
+    if (((newState & WAITER_COUNT_MASK) == 0) && hasRetired_.load(std::memory_order_relaxed)) {
+        ReclaimRetired(static_cast<uint32_t>(newState >> GENERATION_SHIFT));
+    }
+}
+
+void EpollIoWaiter::RetireLocked(std::shared_ptr<FileDescriptorInfo> &&fdInfo)
+{
+    // File descriptor has been removed from epoll, so threads entering later never get its record.
+    uint64_t state = waiterState_.load(std::memory_order_seq_cst);
+    if ((state & WAITER_COUNT_MASK) == 0) {
+        return;
+    }
+    retired_.emplace_back(static_cast<uint32_t>(state >> GENERATION_SHIFT), std::move(fdInfo));
+    hasRetired_.store(true, std::memory_order_relaxed);
+}
+
+void EpollIoWaiter::ReclaimRetired(uint32_t generation)
+{
+    std::vector<std::pair<uint32_t, std::shared_ptr<FileDescriptorInfo>>> reclaimed;
+    {
+        std::lock_guard<std::mutex> lock(fileDescriptorMapLock);
+        auto it = std::partition(retired_.begin(), retired_.end(), [generation](const auto &record) {
+            return static_cast<int32_t>(generation - record.first) <= 0;
+        });
+        std::move(it, retired_.end(), std::back_inserter(reclaimed));
+        retired_.erase(it, retired_.end());
+        hasRetired_.store(!retired_.empty(), std::memory_order_relaxed);
+    }
+    // Listeners are released outside of the lock.
+}
+
+int32_t EpollIoWaiter::Wait(struct epoll_event *events, int32_t maxEvents, int64_t nanoseconds)
+{
+    // Time out in whole milliseconds is exact with epoll_wait.
+    if (!highResolution_ || (nanoseconds <= 0) || ((nanoseconds % NANOSECONDS_PER_ONE_MILLISECOND) == 0)) {
+        return epoll_wait(epollFd_, events, maxEvents, NanosecondsToTimeout(nanoseconds));
+    }
+
+    if (g_epollPwait2Support.load(std::memory_order_relaxed) != EpollPwait2Support::UNSUPPORTED) {
+        int32_t retVal = EpollPwait2(epollFd_, events, maxEvents, nanoseconds);
+        if ((retVal >= 0) || (errno != ENOSYS)) {
+            g_epollPwait2Support.store(EpollPwait2Support::SUPPORTED, std::memory_order_relaxed);
+            return retVal;
+        }
+        HILOGI("epoll_pwait2 is not supported, use timer file descriptor instead");
+        g_epollPwait2Support.store(EpollPwait2Support::UNSUPPORTED, std::memory_order_relaxed);
+    }
+    return WaitWithTimer(events, maxEvents, nanoseconds);
+}
+
+int32_t EpollIoWaiter::WaitWithTimer(struct epoll_event *events, int32_t maxEvents, int64_t nanoseconds)
+{
+    if (timerFd_ < 0) {
+        int32_t timerFd = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+        if (timerFd < 0) {
+            char errmsg[MAX_ERRORMSG_LEN] = {0};
+            GetLastErr(errmsg, MAX_ERRORMSG_LEN);
+            HILOGE("Failed to create timer file descriptor, %{public}s", errmsg);
+            return epoll_wait(epollFd_, events, maxEvents, NanosecondsToTimeout(nanoseconds));
+        }
+        fdsan_exchange_owner_tag(timerFd, 0, EH_LOG_DOMAIN);
+        if (EpollCtrl(epollFd_, EPOLL_CTL_ADD, timerFd, EPOLLIN, &timerFd_) < 0) {
+            char errmsg[MAX_ERRORMSG_LEN] = {0};
+            GetLastErr(errmsg, MAX_ERRORMSG_LEN);
+            HILOGE("Failed to add timer file descriptor into epoll, %{public}s", errmsg);
+            fdsan_close_with_tag(timerFd, EH_LOG_DOMAIN);
+            return epoll_wait(epollFd_, events, maxEvents, NanosecondsToTimeout(nanoseconds));
+        }
+        timerFd_ = timerFd;
+    }
+
+    // Setting the timer also resets expirations left by the last wait.
+    struct itimerspec timeout = {
+        .it_interval = {0, 0},
+        .it_value = {
+            .tv_sec = static_cast<time_t>(nanoseconds / NANOSECONDS_PER_ONE_SECOND),
+            .tv_nsec = static_cast<long>(nanoseconds % NANOSECONDS_PER_ONE_SECOND),
+        },
+    };
+    if (timerfd_settime(timerFd_, 0, &timeout, nullptr) < 0) {
+        return epoll_wait(epollFd_, events, maxEvents, NanosecondsToTimeout(nanoseconds));
+    }
+    return epoll_wait(epollFd_, events, maxEvents, INFINITE_TIMEOUT);
+}
+
+void EpollIoWaiter::EnableHighResolution()
+{
+    highResolution_ = true;
+}
+
+void EpollIoWaiter::SetMaxEventsPerWait(uint32_t maxEvents)
+{
+    maxEventsPerWait_.store(maxEvents, std::memory_order_relaxed);
+}
+
+size_t EpollIoWaiter::GetMaxEventsPerWait() const
+{
+    uint32_t maxEvents = maxEventsPerWait_.load(std::memory_order_relaxed);
+    if (maxEvents > 0) {
+        return maxEvents;
+    }
+    size_t expected = fileDescriptorCount_.load(std::memory_order_relaxed) + INNER_FILE_DESCRIPTORS_COUNT;
+    return std::clamp(expected, MAX_EPOLL_EVENTS_SIZE, MAX_GROWN_EPOLL_EVENTS_SIZE);
+}
+
+bool EpollIoWaiter::RearmFileDescriptor(int32_t fileDescriptor)
+{
+    if (epollFd_ < 0) {
+        HILOGE("MUST initialized before rearming fds");
+        return false;
+    }
+
+    auto fdInfo = GetFileDescriptorMap(fileDescriptor);
+    if (fdInfo == nullptr) {
+        return false;
+    }
+    return Rearm(*fdInfo);
+}
+
+bool EpollIoWaiter::Rearm(FileDescriptorInfo &fdInfo)
+{
+    // Record may be retired, and the file descriptor listened again with a new record.
+    std::lock_guard<std::mutex> lock(fileDescriptorMapLock);
+    auto it = fileDescriptorMap_.find(fdInfo.fileDescriptor_);
+    if ((it == fileDescriptorMap_.end()) || (it->second.get() != &fdInfo)) {
+        return false;
+    }
+
+    if (EpollCtrl(epollFd_, EPOLL_CTL_MOD, fdInfo.fileDescriptor_, fdInfo.epollEvents_, &fdInfo) < 0) {
+        char errmsg[MAX_ERRORMSG_LEN] = {0};
+        GetLastErr(errmsg, MAX_ERRORMSG_LEN);
+        HILOGE("Failed to rearm file descriptor in epoll, %{public}s", errmsg);
+        return false;
+    }
+    return true;
+}
+
 void EpollIoWaiter::NotifyOne()
 {
     // Epoll only support wake up all waiting thread.
@@ -234,8 +453,17 @@ bool EpollIoWaiter::AddFileDescriptor(int32_t fileDescriptor, uint32_t events, c
         epollEvents |= EPOLLOUT;
     }
 
-    InsertFileDescriptorMap(fileDescriptor, taskName, priority, listener);
-    if (EpollCtrl(epollFd_, EPOLL_CTL_ADD, fileDescriptor, epollEvents) < 0) {
+    if ((events & FILE_DESCRIPTOR_EDGE_TRIGGERED) != 0) {
+        epollEvents |= EPOLLET;
+    }
+
+    if ((events & FILE_DESCRIPTOR_ONESHOT) != 0) {
+        epollEvents |= EPOLLONESHOT;
+    }
+
+    auto fdInfo = InsertFileDescriptorMap(fileDescriptor, taskName, priority, listener, epollEvents);
+    fdInfo->modes_ = events & FILE_DESCRIPTOR_MODES_MASK;
+    if (EpollCtrl(epollFd_, EPOLL_CTL_ADD, fileDescriptor, epollEvents, fdInfo.get()) < 0) {
         RemoveFileDescriptor(fileDescriptor);
         char errmsg[MAX_ERRORMSG_LEN] = {0};
         GetLastErr(errmsg, MAX_ERRORMSG_LEN);
@@ -257,7 +485,7 @@ void EpollIoWaiter::RemoveFileDescriptor(int32_t fileDescriptor)
         return;
     }
 
-    if (EpollCtrl(epollFd_, EPOLL_CTL_DEL, fileDescriptor, 0) < 0) {
+    if (EpollCtrl(epollFd_, EPOLL_CTL_DEL, fileDescriptor, 0, nullptr) < 0) {
         char errmsg[MAX_ERRORMSG_LEN] = {0};
         GetLastErr(errmsg, MAX_ERRORMSG_LEN);
         HILOGD("Failed to remove file descriptor from epoll, %{public}s", errmsg);
@@ -270,31 +498,50 @@ void EpollIoWaiter::DrainAwakenPipe() const
 {
     uint64_t value = 0;
     ssize_t retVal = read(awakenFd_, &value, sizeof(value));
-    if (retVal < 0) {
+    // Another thread waiting on the same epoll may have drained it.
+    if ((retVal < 0) && (errno != EAGAIN)) {
         char errmsg[MAX_ERRORMSG_LEN] = {0};
         GetLastErr(errmsg, MAX_ERRORMSG_LEN);
         HILOGE("Failed to read data from awaken pipe, %{public}s", errmsg);
     }
 }
 
+void EpollIoWaiter::DrainTimer() const
+{
+    uint64_t expirations = 0;
+    (void)read(timerFd_, &expirations, sizeof(expirations));
+}
+
 void EpollIoWaiter::SetFileDescriptorEventCallback(const IoWaiter::FileDescriptorEventCallback &callback)
 {
     callback_ = callback;
 }
 
-void EpollIoWaiter::InsertFileDescriptorMap(int32_t fileDescriptor, const std::string& taskName,
-    EventQueue::Priority priority, const std::shared_ptr<FileDescriptorListener>& listener)
+std::shared_ptr<FileDescriptorInfo> EpollIoWaiter::InsertFileDescriptorMap(int32_t fileDescriptor,
+    const std::string& taskName, EventQueue::Priority priority,
+    const std::shared_ptr<FileDescriptorListener>& listener, uint32_t epollEvents)
 {
     std::lock_guard<std::mutex> lock(fileDescriptorMapLock);
     std::shared_ptr<FileDescriptorInfo> fileDescriptorInfo =
         std::make_shared<FileDescriptorInfo>(taskName, priority, listener);
-    fileDescriptorMap_.emplace(fileDescriptor, fileDescriptorInfo);
+    fileDescriptorInfo->epollEvents_ = epollEvents;
+    fileDescriptorInfo->fileDescriptor_ = fileDescriptor;
+    auto result = fileDescriptorMap_.emplace(fileDescriptor, fileDescriptorInfo);
+    fileDescriptorCount_.store(fileDescriptorMap_.size(), std::memory_order_relaxed);
+    return result.first->second;
 }
 
 void EpollIoWaiter::EraseFileDescriptorMap(int32_t fileDescriptor)
 {
     std::lock_guard<std::mutex> lock(fileDescriptorMapLock);
-    fileDescriptorMap_.erase(fileDescriptor);
+    auto it = fileDescriptorMap_.find(fileDescriptor);
+    if (it == fileDescriptorMap_.end()) {
+        return;
+    }
+    // Threads in 'WaitFor' may still hold the record got from epoll.
+    RetireLocked(std::move(it->second));
+    fileDescriptorMap_.erase(it);
+    fileDescriptorCount_.store(fileDescriptorMap_.size(), std::memory_order_relaxed);
 }
 
 std::shared_ptr<FileDescriptorInfo> EpollIoWaiter::GetFileDescriptorMap(int32_t fileDescriptor)
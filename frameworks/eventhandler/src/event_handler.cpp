@@ -26,6 +26,7 @@
 #include "ffrt_inner.h"
 #endif // FFRT_USAGE_ENABLE
 #include "parameters.h"
+#include "thread_info.h"
 #include "thread_local_data.h"
 #include "event_hitrace_meter_adapter.h"
 #include "ffrt_descriptor_listener.h"
@@ -40,6 +41,7 @@ static constexpr int FFRT_ERROR = -1;
 static constexpr int FFRT_TASK_REMOVE_FAIL = 1;
 static constexpr uint64_t MILLISECONDS_TO_NANOSECONDS_RATIO = 1000000;
 static constexpr uint64_t ASYNC_TYPE_EVENTHANDLER = 1ULL << 16;
+static constexpr uint64_t DECIMAL_BASE = 10;
 static const uint64_t PENDING_JOB_TIMEOUT[3] = {
     system::GetIntParameter("const.sys.notification.pending_higher_event_vip", 4),
     system::GetIntParameter("const.sys.notification.pending_higher_event_immediate", 40),
@@ -70,8 +72,7 @@ std::shared_ptr<EventHandler> EventHandler::Current()
 EventHandler::EventHandler(const std::shared_ptr<EventRunner> &runner) : eventRunner_(runner)
 {
     static std::atomic<uint64_t> handlerCount = 1;
-    handlerId_ = std::to_string(handlerCount.load()) + "_" + std::to_string(GetTimeStamp());
-    handlerCount.fetch_add(1);
+    handlerId_ = std::to_string(handlerCount.fetch_add(1)) + "_" + std::to_string(GetTimeStamp());
     HILOGD("Create eventHandler %{public}s", handlerId_.c_str());
 }
 
@@ -89,10 +90,10 @@ EventHandler::~EventHandler()
         if (eventRunner_->threadMode_ == ThreadMode::FFRT) {
             eventRunner_->GetEventQueue()->RemoveOrphanByHandlerId(handlerId_);
         } else {
-            eventRunner_->GetEventQueue()->RemoveOrphan();
+            eventRunner_->GetEventQueue()->RemoveOrphanByOwnerId(GetHandlerNumericId());
         }
 #else
-        eventRunner_->GetEventQueue()->RemoveOrphan();
+        eventRunner_->GetEventQueue()->RemoveOrphanByOwnerId(GetHandlerNumericId());
 #endif
     }
 }
@@ -109,16 +110,33 @@ bool EventHandler::SendEvent(InnerEvent::Pointer &event, int64_t delayTime, Prio
         return false;
     }
 
-    InnerEvent::TimePoint now = InnerEvent::Clock::now();
+    PrepareEvent(event, InnerEvent::Clock::now(), delayTime);
+    // get traceId from event, if HiTraceChain::begin has been called, would get a valid trace id.
+    auto traceId = event->GetOrCreateTraceId();
+    // if traceId is valid, out put trace information
+    bool isAllowHiTrace = AllowHiTraceOutPut(traceId, event->HasWaiter());
+    if (isAllowHiTrace) {
+        HiTracePointerOutPut(traceId, event, "SendEvent", HiTraceTracepointType::HITRACE_TP_CS);
+    }
+    HILOGD("Current event id is %{public}llu .", static_cast<unsigned long long>(event->GetEventUniqueIdValue()));
+    bool ret = eventRunner_->GetEventQueue()->Insert(event, priority);
+    if (isAllowHiTrace) {
+        HiTraceChain::Tracepoint(HiTraceTracepointType::HITRACE_TP_CR, *traceId, "SendEvent over");
+    }
+    return ret;
+}
+
+void EventHandler::PrepareEvent(InnerEvent::Pointer &event, const InnerEvent::TimePoint &now, int64_t delayTime)
+{
     event->SetSendTime(now);
-    event->SetSenderKernelThreadId(getproctid());
+    event->SetSenderKernelThreadId(ThreadInfo::GetKernelThreadId());
     event->SetEventUniqueId();
     if (delayTime > 0) {
         event->SetHandleTime(now + std::chrono::milliseconds(delayTime));
     } else {
         event->SetHandleTime(now);
     }
-    event->SetOwnerId(handlerId_);
+    event->SetOwnerNumericId(GetHandlerNumericId());
     event->SetDelayTime(delayTime);
     event->SetOwner(shared_from_this());
 #ifdef FFRT_USAGE_ENABLE
@@ -130,19 +148,57 @@ bool EventHandler::SendEvent(InnerEvent::Pointer &event, int64_t delayTime, Prio
     uint64_t trackId = AsyncStackAdapter::GetInstance().EventCollectAsyncStack(ASYNC_TYPE_EVENTHANDLER);
     event->SetStackId(trackId);
 #endif
-    // get traceId from event, if HiTraceChain::begin has been called, would get a valid trace id.
-    auto traceId = event->GetOrCreateTraceId();
-    // if traceId is valid, out put trace information
-    bool isAllowHiTrace = AllowHiTraceOutPut(traceId, event->HasWaiter());
-    if (isAllowHiTrace) {
-        HiTracePointerOutPut(traceId, event, "SendEvent", HiTraceTracepointType::HITRACE_TP_CS);
+}
+
+bool EventHandler::SendEvents(std::vector<InnerEvent::Pointer> &events, int64_t delayTime, Priority priority)
+{
+    if (!eventRunner_) {
+        HILOGE("MUST Set event runner before sending events");
+        return false;
     }
-    HILOGD("Current event id is %{public}s .", (event->GetEventUniqueId()).c_str());
-    bool ret = eventRunner_->GetEventQueue()->Insert(event, priority);
-    if (isAllowHiTrace) {
-        HiTraceChain::Tracepoint(HiTraceTracepointType::HITRACE_TP_CR, *traceId, "SendEvent over");
+
+    // Events in a batch share the same send time, so that they are kept in order by the fast path of queue.
+    InnerEvent::TimePoint now = InnerEvent::Clock::now();
+    for (auto &event : events) {
+        if (!event) {
+            HILOGE("Could not send an invalid event");
+            return false;
+        }
+        PrepareEvent(event, now, delayTime);
+        event->SetEventPriority(static_cast<int32_t>(priority));
+        event->GetOrCreateTraceId();
     }
-    return ret;
+    HILOGD("Send %{public}zu events in a batch.", events.size());
+    return eventRunner_->GetEventQueue()->InsertBatch(events);
+}
+
+bool EventHandler::PostTasks(std::vector<TaskSpec> &tasks)
+{
+    if (!eventRunner_) {
+        HILOGE("MUST Set event runner before posting events");
+        return false;
+    }
+
+    std::vector<InnerEvent::Pointer> events;
+    events.reserve(tasks.size());
+    InnerEvent::TimePoint now = InnerEvent::Clock::now();
+    bool ret = true;
+    for (auto &spec : tasks) {
+        auto event = InnerEvent::Get(std::move(spec.task), spec.name, spec.caller);
+        if (!event) {
+            ret = false;
+            continue;
+        }
+        PrepareEvent(event, now, spec.delayTime);
+        event->SetEventPriority(static_cast<int32_t>(spec.priority));
+        if (spec.threadAffine) {
+            event->MarkThreadAffine();
+        }
+        event->GetOrCreateTraceId();
+        events.emplace_back(std::move(event));
+    }
+    HILOGD("Post %{public}zu tasks in a batch.", events.size());
+    return eventRunner_->GetEventQueue()->InsertBatch(events) && ret;
 }
 
 InnerEvent::Pointer EventHandler::CreateTask(const Callback &callback, const std::string &name, Priority priority,
@@ -160,11 +216,11 @@ InnerEvent::Pointer EventHandler::CreateTask(const Callback &callback, const std
     }
 
     event->SetDelayTime(0);
-    event->SetOwnerId(handlerId_);
+    event->SetOwnerNumericId(GetHandlerNumericId());
     InnerEvent::TimePoint now = InnerEvent::Clock::now();
     event->SetSendTime(now);
     event->SetHandleTime(now);
-    event->SetSenderKernelThreadId(getproctid());
+    event->SetSenderKernelThreadId(ThreadInfo::GetKernelThreadId());
     event->SetEventUniqueId();
     event->SetOwner(shared_from_this());
     return event;
@@ -182,7 +238,7 @@ bool EventHandler::PostTaskAtFront(const Callback &callback, const std::string &
     if (isAllowHiTrace) {
         HiTracePointerOutPut(traceId, event, "PostTaskAtFront", HiTraceTracepointType::HITRACE_TP_CS);
     }
-    HILOGD("Current front event id is %{public}s .", (event->GetEventUniqueId()).c_str());
+    HILOGD("Current front event id is %{public}llu .", static_cast<unsigned long long>(event->GetEventUniqueIdValue()));
     bool ret = eventRunner_->GetEventQueue()->Insert(event, priority, EventInsertType::AT_FRONT, option);
     if (isAllowHiTrace) {
         HiTraceChain::Tracepoint(HiTraceTracepointType::HITRACE_TP_CR, *traceId, "PostTaskAtFront over");
@@ -202,7 +258,7 @@ bool EventHandler::PostTaskAtTail(const Callback &callback, const std::string &n
     if (isAllowHiTrace) {
         HiTracePointerOutPut(traceId, event, "PostTaskAtTail", HiTraceTracepointType::HITRACE_TP_CS);
     }
-    HILOGD("Current front event id is %{public}s .", (event->GetEventUniqueId()).c_str());
+    HILOGD("Current front event id is %{public}llu .", static_cast<unsigned long long>(event->GetEventUniqueIdValue()));
     bool ret = eventRunner_->GetEventQueue()->Insert(event, priority, EventInsertType::AT_END, option);
     if (isAllowHiTrace) {
         HiTraceChain::Tracepoint(HiTraceTracepointType::HITRACE_TP_CR, *traceId, "PostTaskAtTail over");
@@ -242,15 +298,18 @@ bool EventHandler::SendSyncEvent(InnerEvent::Pointer &event, Priority priority,
     }
 
     bool result = true;
+    // Workers of pool share the runner, so only events of the handler being distributed by this worker run inline,
+    // otherwise they may run in parallel with events of the same handler distributed by other workers.
+    bool inRunnerThread = (eventRunner_ == EventRunner::Current()) &&
+        ((eventRunner_->threadMode_ != ThreadMode::POOL) || (currentEventHandler.lock().get() == this));
 #ifdef FFRT_USAGE_ENABLE
     if (sameRunnerOnly) {
-        if (eventRunner_ == EventRunner::Current()) {
+        if (inRunnerThread) {
             DistributeEvent(event);
             return true;
         }
     } else {
-        if ((ffrt_this_task_get_id() && eventRunner_->threadMode_ == ThreadMode::FFRT) ||
-            eventRunner_ == EventRunner::Current()) {
+        if ((ffrt_this_task_get_id() && eventRunner_->threadMode_ == ThreadMode::FFRT) || inRunnerThread) {
             DistributeEvent(event);
             return true;
         }
@@ -260,7 +319,7 @@ bool EventHandler::SendSyncEvent(InnerEvent::Pointer &event, Priority priority,
         event->SetSendTime(InnerEvent::Clock::now());
         event->SetEventUniqueId();
         event->SetHandleTime(InnerEvent::Clock::now());
-        event->SetOwnerId(handlerId_);
+        event->SetOwnerNumericId(GetHandlerNumericId());
         event->SetDelayTime(0);
         event->SetOwner(shared_from_this());
         result = eventRunner_->GetEventQueue()->InsertSyncEvent(event, priority);
@@ -277,7 +336,7 @@ bool EventHandler::SendSyncEvent(InnerEvent::Pointer &event, Priority priority,
     }
 #else
     // If send a sync event in same event runner, distribute here.
-    if (eventRunner_ == EventRunner::Current()) {
+    if (inRunnerThread) {
         DistributeEvent(event);
         return true;
     }
@@ -437,7 +496,7 @@ void EventHandler::DeliveryTimeAction(const InnerEvent::Pointer &event, InnerEve
     if (deliveryTimeout > 0) {
         std::string threadName = eventRunner_->GetRunnerThreadName();
         std::string eventName = GetEventName(event);
-        int64_t threadId = getproctid();
+        int64_t threadId = ThreadInfo::GetKernelThreadId();
         std::string threadIdCharacter = std::to_string(threadId);
         std::chrono::duration<double> deliveryTime = nowStart - event->GetSendTime();
         std::string deliveryTimeCharacter = std::to_string((deliveryTime).count());
@@ -466,7 +525,7 @@ void EventHandler::DistributeTimeAction(const InnerEvent::Pointer &event, InnerE
     if (distributeTimeout > 0) {
         std::string threadName = eventRunner_->GetRunnerThreadName();
         std::string eventName = GetEventName(event);
-        int64_t threadId = getproctid();
+        int64_t threadId = ThreadInfo::GetKernelThreadId();
         std::string threadIdCharacter = std::to_string(threadId);
         InnerEvent::TimePoint nowEnd = InnerEvent::Clock::now();
         std::chrono::duration<double> distributeTime = nowEnd - nowStart;
@@ -527,13 +586,13 @@ void EventHandler::DistributeEvent(const InnerEvent::Pointer &event) __attribute
 
     InnerEvent::TimePoint nowStart = InnerEvent::Clock::now();
     DeliveryTimeAction(event, nowStart);
-    HILOGD("EventName: %{public}s, eventId: %{public}s, priority: %{public}d", GetEventName(event).c_str(),
-        (event->GetEventUniqueId()).c_str(), event->GetEventPriority());
+    HILOGD("EventName: %{public}s, eventId: %{public}llu, priority: %{public}d", GetEventName(event).c_str(),
+        static_cast<unsigned long long>(event->GetEventUniqueIdValue()), event->GetEventPriority());
 
     SetCurrentEventPriority(event->GetEventPriority());
     std::string eventName = GetEventName(event);
     InnerEvent::TimePoint beginTime;
-    bool isAppMainThread = EventRunner::IsAppMainThread();
+    bool isAppMainThread = ThreadInfo::IsAppMainThread();
     if (EventRunner::distributeBegin_ && isAppMainThread) {
         beginTime = EventRunner::distributeBegin_(eventName);
     }
@@ -547,7 +606,7 @@ void EventHandler::DistributeEvent(const InnerEvent::Pointer &event) __attribute
     if (event->HasTask()) {
         // Call task callback directly if contains a task.
         HILOGD("excute event taskCallback");
-        (event->GetTaskCallback())();
+        event->RunTask();
     } else {
         // Otherwise let developers to handle it.
         ProcessEvent(event);
@@ -651,6 +710,19 @@ bool EventHandler::HasInnerEvent(int64_t param)
     return eventRunner_->GetEventQueue()->HasInnerEvent(shared_from_this(), param);
 }
 
+uint64_t EventHandler::GetHandlerNumericId() const
+{
+    // Handler id starts with the numeric id, followed by the creation time.
+    uint64_t numericId = 0;
+    for (char c : handlerId_) {
+        if ((c < '0') || (c > '9')) {
+            break;
+        }
+        numericId = numericId * DECIMAL_BASE + static_cast<uint64_t>(c - '0');
+    }
+    return numericId;
+}
+
 std::string EventHandler::GetEventName(const InnerEvent::Pointer &event)
 {
     std::string eventName;
@@ -745,7 +817,7 @@ extern "C" bool PostTaskByFFRT(void* handler, const std::function<void()>& callb
     }
     std::shared_ptr<EventHandler>* ptr = reinterpret_cast<std::shared_ptr<EventHandler>*>(handler);
     Caller caller = {};
-    caller.dfxName_ = task.dfxName_;
+    caller.SetDfxName(task.dfxName_);
     return (*ptr)->PostTask(callback, std::to_string(task.taskId_), task.delayTime_, task.priority_, caller);
 }
 
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "event_index.h"
+
+#include <utility>
+
+namespace OHOS {
+namespace AppExecFwk {
+void EventIndex::LinkBack(EventIndexLink &head, EventIndexLink &link, InnerEvent *event)
+{
+    if (head.next == nullptr) {
+        // New chain, make it circular.
+        head.prev = &head;
+        head.next = &head;
+    }
+    link.event = event;
+    link.prev = head.prev;
+    link.next = &head;
+    head.prev->next = &link;
+    head.prev = &link;
+}
+
+bool EventIndex::Unlink(EventIndexLink &link)
+{
+    // Only the head is left in chain, if both sides of the link are the same.
+    bool empty = (link.prev == link.next);
+    link.prev->next = link.next;
+    link.next->prev = link.prev;
+    link.prev = nullptr;
+    link.next = nullptr;
+    link.event = nullptr;
+    return empty;
+}
+
+void EventIndex::Add(InnerEvent &event)
+{
+    if (event.ownerNumericId_ == 0) {
+        return;
+    }
+    OwnerEntry &owner = owners_[event.ownerNumericId_];
+    LinkBack(owner.events, event.ownerLink_, &event);
+    if (event.HasTask()) {
+        LinkBack(owner.taskNames[event.taskName_], event.keyLink_, &event);
+    } else {
+        LinkBack(owner.eventIds[event.GetInnerEventId()], event.keyLink_, &event);
+    }
+}
+
+void EventIndex::Erase(InnerEvent &event)
+{
+    if (event.ownerLink_.next == nullptr) {
+        return;
+    }
+    bool keyEmpty = Unlink(event.keyLink_);
+    bool ownerEmpty = Unlink(event.ownerLink_);
+    if (!keyEmpty) {
+        return;
+    }
+    auto it = owners_.find(event.ownerNumericId_);
+    if (it == owners_.end()) {
+        return;
+    }
+    if (ownerEmpty) {
+        owners_.erase(it);
+    } else if (event.HasTask()) {
+        it->second.taskNames.erase(event.taskName_);
+    } else {
+        it->second.eventIds.erase(event.GetInnerEventId());
+    }
+}
+
+InnerEvent::Pointer EventIndex::Discard(InnerEvent &event)
+{
+    Erase(event);
+    event.isDiscarded_ = true;
+
+    auto payload = InnerEvent::Get();
+    if (!payload) {
+        // Leave payload in the discarded event, it is released while the event is dropped.
+        return payload;
+    }
+    payload->task_ = std::move(event.task_);
+    std::swap(payload->smartPtrTypeId_, event.smartPtrTypeId_);
+    std::swap(payload->smartPtr_, event.smartPtr_);
+    std::swap(payload->smartPtrDtor_, event.smartPtrDtor_);
+    payload->waiter_ = std::move(event.waiter_);
+    event.waiter_.reset();
+    return payload;
+}
+
+void EventIndex::Clear()
+{
+    for (auto &[ownerId, owner] : owners_) {
+        (void)ownerId;
+        for (EventIndexLink *link = owner.events.next; link != &owner.events;) {
+            EventIndexLink *next = link->next;
+            InnerEvent *event = link->event;
+            *link = EventIndexLink();
+            event->keyLink_ = EventIndexLink();
+            link = next;
+        }
+    }
+    owners_.clear();
+}
+
+const EventIndexLink *EventIndex::FindOwner(uint64_t ownerId) const
+{
+    auto it = owners_.find(ownerId);
+    return (it == owners_.end()) ? nullptr : &it->second.events;
+}
+
+const EventIndexLink *EventIndex::FindEventId(uint64_t ownerId, uint32_t innerEventId) const
+{
+    auto it = owners_.find(ownerId);
+    if (it == owners_.end()) {
+        return nullptr;
+    }
+    auto idIt = it->second.eventIds.find(innerEventId);
+    return (idIt == it->second.eventIds.end()) ? nullptr : &idIt->second;
+}
+
+const EventIndexLink *EventIndex::FindTaskName(uint64_t ownerId, const std::string &name) const
+{
+    auto it = owners_.find(ownerId);
+    if (it == owners_.end()) {
+        return nullptr;
+    }
+    auto nameIt = it->second.taskNames.find(name);
+    return (nameIt == it->second.taskNames.end()) ? nullptr : &nameIt->second;
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
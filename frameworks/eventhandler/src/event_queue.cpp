@@ -19,6 +19,7 @@
 #include <iterator>
 #include <mutex>
 
+#include "adaptive_lock.h"
 #include "deamon_io_waiter.h"
 #include "epoll_io_waiter.h"
 #include "event_handler.h"
@@ -66,6 +67,12 @@ void EventQueue::InitializeLocks(EventLockType lockType)
         case EventLockType::PRIORITY_INHERIT:
             queueLock_ = std::make_unique<PriorityInheritanceLock>();
             break;
+        case EventLockType::ADAPTIVE:
+            queueLock_ = std::make_unique<AdaptiveLock>();
+            break;
+        case EventLockType::ADAPTIVE_PRIORITY_INHERIT:
+            queueLock_ = std::make_unique<AdaptivePriorityInheritanceLock>();
+            break;
         case EventLockType::STANDARD:
         default:
             queueLock_ = std::make_unique<StdLock>();
@@ -87,8 +94,8 @@ EventQueue::EventQueue(const std::shared_ptr<IoWaiter> &ioWaiter)
     if (ioWaiter_->SupportListeningFileDescriptor()) {
         // Set callback to handle events from file descriptors.
         ioWaiter_->SetFileDescriptorEventCallback(
-            std::bind(&EventQueue::HandleFileDescriptorEvent, this, std::placeholders::_1, std::placeholders::_2,
-            std::placeholders::_3, std::placeholders::_4));
+            std::bind(&EventQueue::DispatchFileDescriptorEvent, this, std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
     }
 }
 
@@ -106,8 +113,8 @@ EventQueue::EventQueue(const std::shared_ptr<IoWaiter> &ioWaiter, EventLockType
     if (ioWaiter_->SupportListeningFileDescriptor()) {
         // Set callback to handle events from file descriptors.
         ioWaiter_->SetFileDescriptorEventCallback(
-            std::bind(&EventQueue::HandleFileDescriptorEvent, this, std::placeholders::_1, std::placeholders::_2,
-            std::placeholders::_3, std::placeholders::_4));
+            std::bind(&EventQueue::DispatchFileDescriptorEvent, this, std::placeholders::_1, std::placeholders::_2,
+            std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
     }
 }
 
@@ -116,6 +123,20 @@ EventQueue::~EventQueue()
     EH_LOGD_LIMIT("EventQueue is unavailable hence");
 }
 
+bool EventQueue::InsertBatch(std::vector<InnerEvent::Pointer> &events)
+{
+    bool ret = true;
+    for (auto &event : events) {
+        if (!event) {
+            ret = false;
+            continue;
+        }
+        auto priority = static_cast<Priority>(event->GetEventPriority());
+        ret = Insert(event, priority) && ret;
+    }
+    return ret;
+}
+
 InnerEvent::Pointer EventQueue::GetEvent()
 {
     return InnerEvent::Pointer(nullptr, nullptr);
@@ -137,6 +158,22 @@ void EventQueue::WaitUntilLocked(const InnerEvent::TimePoint &when, UniqueLockBa
     }
 }
 
+void EventQueue::RearmFileDescriptorListener(int32_t fileDescriptor)
+{
+    std::shared_ptr<IoWaiter> ioWaiter;
+    {
+        LockGuardBase lock(*queueLock_);
+        // Listener may be removed while its events are being handled.
+        if (listeners_.find(fileDescriptor) == listeners_.end()) {
+            return;
+        }
+        ioWaiter = ioWaiter_;
+    }
+    if (ioWaiter && !ioWaiter->RearmFileDescriptor(fileDescriptor)) {
+        HILOGW("Failed to listen file descriptor %{public}d again", fileDescriptor);
+    }
+}
+
 void EventQueue::CheckFileDescriptorEvent()
 {
     InnerEvent::TimePoint now = InnerEvent::Clock::now();
@@ -190,8 +227,8 @@ bool EventQueue::EnsureIoWaiterLocked(const std::shared_ptr<FileDescriptorListen
 
     // Set callback to handle events from file descriptors.
     newIoWaiter->SetFileDescriptorEventCallback(
-        std::bind(&EventQueue::HandleFileDescriptorEvent, this, std::placeholders::_1, std::placeholders::_2,
-        std::placeholders::_3, std::placeholders::_4));
+        std::bind(&EventQueue::DispatchFileDescriptorEvent, this, std::placeholders::_1, std::placeholders::_2,
+        std::placeholders::_3, std::placeholders::_4, std::placeholders::_5));
 
     ioWaiter_->NotifyAll();
     ioWaiter_ = newIoWaiter;
@@ -257,12 +294,21 @@ std::shared_ptr<FileDescriptorListener> EventQueue::GetListenerByfd(int32_t file
 }
 
 void EventQueue::HandleFileDescriptorEvent(int32_t fileDescriptor, uint32_t events,
-    const std::string &taskName, Priority priority) __attribute__((no_sanitize("cfi")))
+    const std::string &taskName, Priority priority)
 {
     std::shared_ptr<FileDescriptorListener> listener = GetListenerByfd(fileDescriptor);
     if (!listener) {
         return;
     }
+    DispatchFileDescriptorEvent(fileDescriptor, events, taskName, priority, listener);
+}
+
+void EventQueue::DispatchFileDescriptorEvent(int32_t fileDescriptor, uint32_t events, const std::string &taskName,
+    Priority priority, const std::shared_ptr<FileDescriptorListener> &listener) __attribute__((no_sanitize("cfi")))
+{
+    if (!listener || !usable_.load()) {
+        return;
+    }
 
     auto handler = listener->GetOwner();
     if (!handler) {
@@ -270,7 +316,17 @@ void EventQueue::HandleFileDescriptorEvent(int32_t fileDescriptor, uint32_t even
         return;
     }
 
-    bool isVsyncTask = handler->GetEventRunner() && listener->IsVsyncListener();
+    // Vsync scheduling relies on a single running thread.
+    bool isVsyncTask = !IsWorkerPool() && handler->GetEventRunner() && listener->IsVsyncListener();
+    if (!isVsyncTask && ((events & FILE_DESCRIPTOR_COALESCED) != 0) &&
+        CoalesceFileDescriptorEvent(fileDescriptor, events)) {
+        return;
+    }
+    if (!isVsyncTask && ((events & FILE_DESCRIPTOR_DIRECT_DISPATCH) != 0) &&
+        PushDirectFileDescriptorEvent(fileDescriptor, events, priority, listener)) {
+        return;
+    }
+
     std::weak_ptr<FileDescriptorListener> wp = listener;
     auto f = [fileDescriptor, events, wp, isVsyncTask]() {
         auto queue = EventRunner::Current()->GetEventQueue();
@@ -284,33 +340,48 @@ void EventQueue::HandleFileDescriptorEvent(int32_t fileDescriptor, uint32_t even
             return;
         }
 
-        if ((events & FILE_DESCRIPTOR_INPUT_EVENT) != 0) {
-            listener->OnReadable(fileDescriptor);
-        }
-
-        if ((events & FILE_DESCRIPTOR_OUTPUT_EVENT) != 0) {
-            listener->OnWritable(fileDescriptor);
-        }
-
-        if ((events & FILE_DESCRIPTOR_SHUTDOWN_EVENT) != 0) {
-            listener->OnShutdown(fileDescriptor);
-        }
-
-        if ((events & FILE_DESCRIPTOR_EXCEPTION_EVENT) != 0) {
-            listener->OnException(fileDescriptor);
+        uint32_t allEvents = events;
+        if (!isVsyncTask && ((events & FILE_DESCRIPTOR_COALESCED) != 0)) {
+            allEvents = queue->TakeCoalescedFileDescriptorEvents(fileDescriptor, events);
         }
+        NotifyFileDescriptorListener(listener, fileDescriptor, allEvents);
 
         if (isVsyncTask) {
             queue->HandleVsyncTaskCompletely();
         }
+
+        if ((events & FILE_DESCRIPTOR_ONESHOT) != 0) {
+            queue->RearmFileDescriptorListener(fileDescriptor);
+        }
     };
 
     HILOGD("Post fd %{public}d, task %{public}s, priority %{public}d.", fileDescriptor, taskName.c_str(), priority);
     // Post a high priority task to handle file descriptor events.
     if (isVsyncTask) {
         PostTaskForVsync(f, taskName, handler, priority);
-    } else {
-        handler->PostTask(f, taskName, 0, priority);
+    } else if (!handler->PostTask(f, taskName, 0, priority) && ((events & FILE_DESCRIPTOR_COALESCED) != 0)) {
+        // No call is pending, so that events reported later are not merged into nothing.
+        (void)TakeCoalescedFileDescriptorEvents(fileDescriptor, events);
+    }
+}
+
+void EventQueue::NotifyFileDescriptorListener(const std::shared_ptr<FileDescriptorListener> &listener,
+    int32_t fileDescriptor, uint32_t events) __attribute__((no_sanitize("cfi")))
+{
+    if ((events & FILE_DESCRIPTOR_INPUT_EVENT) != 0) {
+        listener->OnReadable(fileDescriptor);
+    }
+
+    if ((events & FILE_DESCRIPTOR_OUTPUT_EVENT) != 0) {
+        listener->OnWritable(fileDescriptor);
+    }
+
+    if ((events & FILE_DESCRIPTOR_SHUTDOWN_EVENT) != 0) {
+        listener->OnShutdown(fileDescriptor);
+    }
+
+    if ((events & FILE_DESCRIPTOR_EXCEPTION_EVENT) != 0) {
+        listener->OnException(fileDescriptor);
     }
 }
 
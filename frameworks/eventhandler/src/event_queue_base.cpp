@@ -20,7 +20,9 @@
 #include <chrono>
 #include <iterator>
 #include <mutex>
+#include <thread>
 
+#include "cpu_relax.h"
 #include "deamon_io_waiter.h"
 #include "epoll_io_waiter.h"
 #include "event_handler.h"
@@ -30,6 +32,9 @@
 #include "none_io_waiter.h"
 #include "event_hitrace_meter_adapter.h"
 #include "parameters.h"
+#include "queue_lock_guard.h"
+#include "stealing_group.h"
+#include "thread_info.h"
 
 namespace OHOS {
 namespace AppExecFwk {
@@ -47,44 +52,14 @@ static const int32_t VSYNC_TASK_DELAYMS_NO_BARRIER = system::GetIntParameter("co
 static const int32_t VSYNC_TASK_DELAYMS_DEFAULT_BARRIER = system::GetIntParameter("const.sys.param_vsync_delayms", 50);
 static const int32_t VSYNC_BARRIER_TIMEOUT = system::GetIntParameter("const.sys.param_vsync_barrier_timeout", 100);
 static constexpr int64_t MILLISECONDS_TO_NANOSECONDS_RATIO = 1000000;
-// Help to insert events into the event queue sorted by handle time.
-void InsertEventsLocked(std::list<InnerEvent::Pointer> &events, InnerEvent::Pointer &event,
-    EventInsertType insertType)
-{
-    if (insertType == EventInsertType::AT_FRONT) {
-        if (!events.empty()) {
-            // Ensure that events queue is in ordered
-            auto headEvent = events.begin();
-            if ((*headEvent)->GetHandleTime() < event->GetHandleTime()) {
-                event->SetHandleTime((*headEvent)->GetHandleTime());
-            }
-        }
-        events.emplace_front(std::move(event));
-        return;
-    }
-
-    auto it = events.end();
-    auto eventTime = event->GetHandleTime();
-    while (it != events.begin()) {
-        auto prevIt = std::prev(it);
-        if ((*prevIt) == nullptr) {
-            it = prevIt;
-            continue;
-        }
-        if ((*prevIt)->GetHandleTime() <= eventTime) {
-            break;
-        }
-        it = prevIt;
-    }
-    events.insert(it, std::move(event));
-}
-
-// Help to check whether there is a valid event in list and update wake up time.
-inline bool CheckEventInListLocked(const std::list<InnerEvent::Pointer> &events, const InnerEvent::TimePoint &now,
+// Read the clock once per so many rounds of busy poll, since it costs much more than a round.
+constexpr uint32_t BUSY_POLL_CLOCK_CHECK_MASK = 0x3F;
+// Help to check whether there is a valid event in queue and update wake up time.
+inline bool CheckEventInListLocked(const SortedEventQueue &events, const InnerEvent::TimePoint &now,
     InnerEvent::TimePoint &nextWakeUpTime)
 {
-    if (!events.empty()) {
-        const auto &handleTime = events.front()->GetHandleTime();
+    if (!events.Empty()) {
+        const auto &handleTime = events.Front()->GetHandleTime();
         if (handleTime < nextWakeUpTime) {
             nextWakeUpTime = handleTime;
             return handleTime <= now;
@@ -93,64 +68,51 @@ inline bool CheckEventInListLocked(const std::list<InnerEvent::Pointer> &events,
     return false;
 }
 
-inline bool CheckBarrierTaskInListLocked(const std::list<InnerEvent::Pointer> &events, const InnerEvent::TimePoint &now,
+inline bool CheckBarrierTaskInListLocked(const SortedEventQueue &events, const InnerEvent::TimePoint &now,
     InnerEvent::TimePoint &nextWakeUpTime)
 {
-    if (events.empty()) return false;
-    for (auto it = events.begin(); it != events.end(); it++) {
-        const auto &handleTime = (*it)->GetHandleTime();
-        if (handleTime < nextWakeUpTime) nextWakeUpTime = handleTime;
-        if (handleTime > now) break;
-        if ((*it)->IsBarrierTask()) return true;
-    }
-    return false;
+    if (events.Empty()) return false;
+    const auto &handleTime = events.Front()->GetHandleTime();
+    if (handleTime < nextWakeUpTime) nextWakeUpTime = handleTime;
+    if (handleTime > now) return false;
+    return events.HasIf([&now](const InnerEvent::Pointer &p) {
+        return p->IsBarrierTask() && (p->GetHandleTime() <= now);
+    });
 }
 
-inline InnerEvent::Pointer PopFrontEventFromListLocked(std::list<InnerEvent::Pointer> &events)
-{
-    InnerEvent::Pointer event = std::move(events.front());
-    events.pop_front();
-    return event;
-}
-
-inline InnerEvent::Pointer PopFrontBarrierEventFromListLocked(std::list<InnerEvent::Pointer> &events)
+inline InnerEvent::Pointer PopFrontBarrierEventFromListLocked(SortedEventQueue &events)
 {
     auto filter = [](const InnerEvent::Pointer &p) {
         return p->IsBarrierTask();
     };
-    std::list<InnerEvent::Pointer>::iterator iter = std::find_if(events.begin(), events.end(), filter);
-    if (iter != events.end()) {
-        std::list<InnerEvent::Pointer> tempList;
-        tempList.splice(tempList.begin(), events, iter);
-        return PopFrontEventFromListLocked(tempList);
-    }
-    return InnerEvent::Pointer(nullptr, nullptr);
+    return events.PopFirst(filter);
 }
 
-inline InnerEvent::Pointer PopFrontBarrierEventFromListWithTimeLocked(std::list<InnerEvent::Pointer> &events,
+inline InnerEvent::Pointer PopFrontBarrierEventFromListWithTimeLocked(SortedEventQueue &events,
     const InnerEvent::TimePoint &sendTime, const InnerEvent::TimePoint &handleTime)
 {
     auto filter = [&sendTime, &handleTime](const InnerEvent::Pointer &p) {
         return p->IsBarrierTask() && (p->GetSendTime() <= sendTime) && (p->GetHandleTime() <= handleTime);
     };
-    std::list<InnerEvent::Pointer>::iterator iter = std::find_if(events.begin(), events.end(), filter);
-    if (iter != events.end()) {
-        std::list<InnerEvent::Pointer> tempList;
-        tempList.splice(tempList.begin(), events, iter);
-        return PopFrontEventFromListLocked(tempList);
-    }
-    return InnerEvent::Pointer(nullptr, nullptr);
+    return events.PopFirst(filter);
+}
+
+inline uint64_t GetFrontEventHandleTimeLocked(const SortedEventQueue &events)
+{
+    return events.Empty() ? UINT64_MAX :
+        static_cast<uint64_t>(events.Front()->GetHandleTime().time_since_epoch().count());
 }
 }  // unnamed namespace
 
 EventQueueBase::EventQueueBase(EventLockType lockType)
-    : EventQueue(lockType), historyEvents_(std::vector<HistoryEvent>(HISTORY_EVENT_NUM_POWER))
+    : EventQueue(lockType), lockType_(lockType), historyEvents_(std::vector<HistoryEvent>(HISTORY_EVENT_NUM_POWER))
 {
     HILOGD("enter");
 }
 
 EventQueueBase::EventQueueBase(const std::shared_ptr<IoWaiter> &ioWaiter, EventLockType lockType)
-    : EventQueue(ioWaiter, lockType), historyEvents_(std::vector<HistoryEvent>(HISTORY_EVENT_NUM_POWER))
+    : EventQueue(ioWaiter, lockType), lockType_(lockType),
+      historyEvents_(std::vector<HistoryEvent>(HISTORY_EVENT_NUM_POWER))
 {
     HILOGD("enter");
 }
@@ -177,10 +139,10 @@ static inline void MarkBarrierTaskIfNeed(InnerEvent::Pointer &event, VsyncBarrie
         needMarkBarrier = (__builtin_expect(option == VsyncBarrierOption::FORCE_BARRIER, 0) ||
             event->GetEventPriority() == static_cast<int32_t>(EventQueue::Priority::VIP) ||
             (__builtin_expect(option == VsyncBarrierOption::NEED_BARRIER, 0) &&
-            EventRunner::IsAppMainThread() && (event->GetHandleTime() == event->GetSendTime()) &&
+            ThreadInfo::IsAppMainThread() && (event->GetHandleTime() == event->GetSendTime()) &&
             IsOwnerMainRunner(event))) && !event->IsVsyncTask();
     } else if (vsyncPolicy == VsyncPolicy::VSYNC_FIRST_WITH_DEFAULT_BARRIER) {
-        needMarkBarrier = EventRunner::IsAppMainThread() && (event->GetHandleTime() == event->GetSendTime()) &&
+        needMarkBarrier = ThreadInfo::IsAppMainThread() && (event->GetHandleTime() == event->GetSendTime()) &&
             IsOwnerMainRunner(event) && !event->IsVsyncTask();
     }
     if (needMarkBarrier) {
@@ -188,6 +150,20 @@ static inline void MarkBarrierTaskIfNeed(InnerEvent::Pointer &event, VsyncBarrie
     }
 }
 
+inline void EventQueueBase::CheckPickedEventsOnInsertLocked(const InnerEvent::Pointer &event, uint32_t priority,
+    EventInsertType insertType)
+{
+    if (__builtin_expect(pickedIndex_ >= pickedEvents_.size(), 1)) {
+        return;
+    }
+    // Put picked events back, if the new one should be distributed before some of them.
+    bool withoutDelay = (event->GetHandleTime() <= event->GetSendTime());
+    if ((insertType == EventInsertType::AT_FRONT) || event->IsVsyncTask() ||
+        (withoutDelay && (priority < pickedPriorityBound_))) {
+        ReturnPickedEventsLocked();
+    }
+}
+
 bool EventQueueBase::Insert(InnerEvent::Pointer &event, Priority priority, EventInsertType insertType,
     VsyncBarrierOption option)
 {
@@ -195,15 +171,32 @@ bool EventQueueBase::Insert(InnerEvent::Pointer &event, Priority priority, Event
         HILOGE("Could not insert an invalid event");
         return false;
     }
-    HILOGD("Insert task: %{public}s %{public}d.", (event->GetEventUniqueId()).c_str(), insertType);
+    HILOGD("Insert task: %{public}llu %{public}d.", static_cast<unsigned long long>(event->GetEventUniqueIdValue()),
+        insertType);
     MarkBarrierTaskIfNeed(event, option, vsyncPolicy_);
-    LockGuardBase lock(*queueLock_);
+    // Declared before the lock guard, so that idle peers in stealing group are notified without the lock.
+    StealableNotification stealable;
+    bool canSteal = IsStealableOnInsert(event, priority);
+    if (ingressQueue_ && (insertType == EventInsertType::AT_END) && !event->IsVsyncTask()) {
+        if (canSteal) {
+            stealable.Arm(stealingGroup_, stealingIndex_);
+        }
+        return PushIngress(event, priority);
+    }
+    QueueLockGuard lock(lockType_, *queueLock_);
     if (!usable_.load()) {
         HILOGW("EventQueue is unavailable.");
         return false;
     }
+    // Keep events posted before this one ahead of it.
+    DrainIngressLocked();
+    if (canSteal && (sleepingCount_ == 0)) {
+        // The runner is busy, let an idle peer take the task.
+        stealable.Arm(stealingGroup_, stealingIndex_);
+    }
     bool needNotify = false;
     event->SetEventPriority(static_cast<int32_t>(priority));
+    CheckPickedEventsOnInsertLocked(event, static_cast<uint32_t>(priority), insertType);
     switch (priority) {
         case Priority::VIP:
         case Priority::IMMEDIATE:
@@ -214,15 +207,22 @@ bool EventQueueBase::Insert(InnerEvent::Pointer &event, Priority priority, Event
                 needNotify = true;
                 DispatchVsyncTaskNotify();
             }
-            InsertEventsLocked(subEventQueues_[static_cast<uint32_t>(priority)].queue, event, insertType);
-            subEventQueues_[static_cast<uint32_t>(priority)].frontEventHandleTime =
-                static_cast<uint64_t>((*subEventQueues_[static_cast<uint32_t>(priority)].queue.begin())
-                    ->GetHandleTime().time_since_epoch().count());
+            eventIndex_.Add(*event);
+            // Delayed events wait in timing wheel until they are about to expire.
+            if (timingWheel_ && (insertType == EventInsertType::AT_END) && !event->IsVsyncTask() &&
+                (event->GetHandleTime() > event->GetSendTime()) &&
+                timingWheel_->Add(event, static_cast<uint32_t>(priority))) {
+                break;
+            }
+            SubEventQueue &subQueue = subEventQueues_[static_cast<uint32_t>(priority)];
+            subQueue.queue.Insert(event, insertType);
+            subQueue.frontEventHandleTime = GetFrontEventHandleTimeLocked(subQueue.queue);
             break;
         }
         case Priority::IDLE: {
             // Never wake up thread if insert an idle event.
-            InsertEventsLocked(idleEvents_, event, insertType);
+            eventIndex_.Add(*event);
+            idleEvents_.Insert(event, insertType);
             break;
         }
         default:
@@ -230,7 +230,7 @@ bool EventQueueBase::Insert(InnerEvent::Pointer &event, Priority priority, Event
     }
 
     if (needNotify) {
-        ioWaiter_->NotifyOne();
+        NotifyOneLocked();
     }
 #ifdef NOTIFICATIONG_SMART_GC
     if (priority == Priority::VIP && !isExistVipTask_) {
@@ -242,6 +242,148 @@ bool EventQueueBase::Insert(InnerEvent::Pointer &event, Priority priority, Event
     return true;
 }
 
+bool EventQueueBase::InsertBatch(std::vector<InnerEvent::Pointer> &events)
+{
+    bool canSteal = false;
+    for (auto &event : events) {
+        if (event) {
+            MarkBarrierTaskIfNeed(event, VsyncBarrierOption::NO_BARRIER, vsyncPolicy_);
+            canSteal = canSteal || IsStealableOnInsert(event, static_cast<Priority>(event->GetEventPriority()));
+        }
+    }
+    // Declared before the lock guard, so that idle peers in stealing group are notified without the lock.
+    StealableNotification stealable;
+    if (ingressQueue_) {
+        if (canSteal) {
+            stealable.Arm(stealingGroup_, stealingIndex_);
+        }
+        return PushIngressBatch(events);
+    }
+    bool needNotify = false;
+    QueueLockGuard lock(lockType_, *queueLock_);
+    if (!usable_.load()) {
+        HILOGW("EventQueue is unavailable.");
+        return false;
+    }
+    if (canSteal && (sleepingCount_ == 0)) {
+        stealable.Arm(stealingGroup_, stealingIndex_);
+    }
+    bool ret = InsertBatchLocked(events, needNotify);
+    if (needNotify) {
+        NotifyOneLocked();
+    }
+    return ret;
+}
+
+bool EventQueueBase::InsertBatchLocked(std::vector<InnerEvent::Pointer> &events, bool &needNotify)
+{
+    // Events of each priority are collected and inserted into its sub queue together.
+    std::array<std::vector<InnerEvent::Pointer>, SUB_EVENT_QUEUE_NUM> batches;
+    bool ret = true;
+    bool hasVipEvent = false;
+    bool wakeUpTimePassed = (wakeUpTime_ < InnerEvent::Clock::now());
+    for (auto &event : events) {
+        if (!event) {
+            HILOGE("Could not insert an invalid event");
+            ret = false;
+            continue;
+        }
+        uint32_t priority = static_cast<uint32_t>(event->GetEventPriority());
+        if (priority == static_cast<uint32_t>(Priority::IDLE)) {
+            // Never wake up thread if insert an idle event.
+            eventIndex_.Add(*event);
+            idleEvents_.Insert(event);
+            continue;
+        }
+        if (priority >= SUB_EVENT_QUEUE_NUM) {
+            HILOGE("Could not insert an event with invalid priority %{public}u", priority);
+            ret = false;
+            continue;
+        }
+        CheckPickedEventsOnInsertLocked(event, priority, EventInsertType::AT_END);
+        hasVipEvent = hasVipEvent || (priority == static_cast<uint32_t>(Priority::VIP));
+        needNotify = needNotify || wakeUpTimePassed || (event->GetHandleTime() < wakeUpTime_);
+        if (event->IsVsyncTask()) {
+            needNotify = true;
+            DispatchVsyncTaskNotify();
+        }
+        eventIndex_.Add(*event);
+        if (timingWheel_ && !event->IsVsyncTask() && (event->GetHandleTime() > event->GetSendTime()) &&
+            timingWheel_->Add(event, priority)) {
+            continue;
+        }
+        batches[priority].emplace_back(std::move(event));
+    }
+    for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
+        if (batches[i].empty()) {
+            continue;
+        }
+        subEventQueues_[i].queue.InsertBatch(batches[i]);
+        subEventQueues_[i].frontEventHandleTime = GetFrontEventHandleTimeLocked(subEventQueues_[i].queue);
+    }
+#ifdef NOTIFICATIONG_SMART_GC
+    if (hasVipEvent && !isExistVipTask_) {
+        isExistVipTask_ = true;
+        InnerEvent::TimePoint time = InnerEvent::Clock::now();
+        TryExecuteObserverCallback(time, EventRunnerStage::STAGE_VIP_EXISTED);
+    }
+#else
+    (void)hasVipEvent;
+#endif
+    return ret;
+}
+
+bool EventQueueBase::PushIngress(InnerEvent::Pointer &event, Priority priority)
+{
+    if (!usable_.load()) {
+        HILOGW("EventQueue is unavailable.");
+        return false;
+    }
+    event->SetEventPriority(static_cast<int32_t>(priority));
+    if (ingressQueue_->Push(event)) {
+        WakeUpIngressWaiter();
+    }
+    return true;
+}
+
+bool EventQueueBase::PushIngressBatch(std::vector<InnerEvent::Pointer> &events)
+{
+    if (!usable_.load()) {
+        HILOGW("EventQueue is unavailable.");
+        return false;
+    }
+    auto it = std::remove_if(events.begin(), events.end(), [](const InnerEvent::Pointer &event) {
+        return !event || (static_cast<uint32_t>(event->GetEventPriority()) > static_cast<uint32_t>(Priority::IDLE));
+    });
+    bool ret = (it == events.end());
+    if (!ret) {
+        HILOGE("Could not insert invalid events");
+        events.erase(it, events.end());
+    }
+    if (ingressQueue_->PushBatch(events)) {
+        WakeUpIngressWaiter();
+    }
+    return ret;
+}
+
+void EventQueueBase::WakeUpIngressWaiter()
+{
+    // The runner has announced waiting while holding the lock, so it is blocked in IO waiter once the lock is got.
+    QueueLockGuard lock(lockType_, *queueLock_);
+    if (ioWaiter_) {
+        NotifyOneLocked();
+    }
+}
+
+void EventQueueBase::DrainIngressSlowLocked()
+{
+    std::vector<InnerEvent::Pointer> events;
+    ingressQueue_->PopAll(events);
+    // Runner waiting for these events has been notified by their producers.
+    bool needNotify = false;
+    (void)InsertBatchLocked(events, needNotify);
+}
+
 void EventQueueBase::RemoveOrphan()
 {
     HILOGD("enter");
@@ -264,6 +406,7 @@ void EventQueueBase::RemoveOrphan()
         return;
     }
     RemoveInvalidFileDescriptor();
+    PruneCoalescedFileDescriptorEventsLocked();
 }
 
 
@@ -275,11 +418,18 @@ void EventQueueBase::RemoveAll()
         HILOGW("RemoveAll EventQueueBase is unavailable.");
         return;
     }
+    DrainIngressLocked();
+    ReturnPickedEventsLocked();
+    // Unlink events from index while they are alive, since releasing them resets their links.
+    eventIndex_.Clear();
     for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
-        subEventQueues_[i].queue.clear();
+        subEventQueues_[i].queue.Clear();
         subEventQueues_[i].frontEventHandleTime = UINT64_MAX;
     }
-    idleEvents_.clear();
+    idleEvents_.Clear();
+    if (timingWheel_) {
+        timingWheel_->Clear();
+    }
 }
 
 void EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner)
@@ -290,9 +440,10 @@ void EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner)
         return;
     }
 
-    auto filter = [&owner](const InnerEvent::Pointer &p) { return (p->GetOwnerId() == owner->GetHandlerId()); };
+    uint64_t ownerId = owner->GetHandlerNumericId();
+    auto finder = [ownerId](const EventIndex &index) { return index.FindOwner(ownerId); };
 
-    Remove(filter);
+    Remove(finder, nullptr);
 }
 
 void EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner, uint32_t innerEventId)
@@ -302,11 +453,12 @@ void EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner, uint32_t
         HILOGE("Invalid owner");
         return;
     }
-    auto filter = [&owner, innerEventId](const InnerEvent::Pointer &p) {
-        return (!p->HasTask()) && (p->GetOwnerId() == owner->GetHandlerId()) && (p->GetInnerEventId() == innerEventId);
+    uint64_t ownerId = owner->GetHandlerNumericId();
+    auto finder = [ownerId, innerEventId](const EventIndex &index) {
+        return index.FindEventId(ownerId, innerEventId);
     };
 
-    Remove(filter);
+    Remove(finder, nullptr);
 }
 
 void EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner, uint32_t innerEventId, int64_t param)
@@ -317,12 +469,13 @@ void EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner, uint32_t
         return;
     }
 
-    auto filter = [&owner, innerEventId, param](const InnerEvent::Pointer &p) {
-        return (!p->HasTask()) && (p->GetOwnerId() == owner->GetHandlerId()) && (p->GetInnerEventId() == innerEventId)
-        && (p->GetParam() == param);
+    uint64_t ownerId = owner->GetHandlerNumericId();
+    auto finder = [ownerId, innerEventId](const EventIndex &index) {
+        return index.FindEventId(ownerId, innerEventId);
     };
+    auto filter = [param](InnerEvent &event) { return event.GetParam() == param; };
 
-    Remove(filter);
+    Remove(finder, filter);
 }
 
 bool EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner, const std::string &name)
@@ -333,71 +486,98 @@ bool EventQueueBase::Remove(const std::shared_ptr<EventHandler> &owner, const st
         return false;
     }
 
-    bool removed = false;
-    auto filter = [&owner, &name, &removed](const InnerEvent::Pointer &p) {
-        if (p == nullptr) {
-            return false;
-        }
-        bool ret = (p->HasTask()) && (p->GetOwnerId() == owner->GetHandlerId()) && (p->GetTaskName() == name);
-        if (!removed) {
-            removed = ret;
-        }
-        return ret;
-    };
+    uint64_t ownerId = owner->GetHandlerNumericId();
+    auto finder = [ownerId, &name](const EventIndex &index) { return index.FindTaskName(ownerId, name); };
 
-    Remove(filter);
-    return removed;
+    return Remove(finder, nullptr);
 }
 
-void EventQueueBase::Remove(const RemoveFilter &filter) __attribute__((no_sanitize("cfi")))
+bool EventQueueBase::Remove(const IndexFinder &finder, const IndexFilter &filter) __attribute__((no_sanitize("cfi")))
 {
     HILOGD("Remove filter enter");
-    LockGuardBase lock(*queueLock_);
+    // Declared before the lock, so that task callbacks and smart pointers of removed events are released out of it.
+    std::list<InnerEvent::Pointer> releaseEvents;
+    QueueLockGuard lock(lockType_, *queueLock_);
     if (!usable_.load()) {
         HILOGW("EventQueueBase is unavailable.");
-        return;
+        return false;
     }
+    DrainIngressLocked();
 #ifdef NOTIFICATIONG_SMART_GC
     bool result = HasVipTask();
 #endif
-    for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
-        subEventQueues_[i].queue.remove_if(filter);
-        subEventQueues_[i].frontEventHandleTime = (subEventQueues_[i].queue.size() ?
-            static_cast<uint64_t>((*subEventQueues_[i].queue.begin())
-            ->GetHandleTime().time_since_epoch().count()) : UINT64_MAX);
-    }
-    idleEvents_.remove_if(filter);
+    bool removed = DiscardEventsLocked(finder(eventIndex_), filter, releaseEvents);
 #ifdef NOTIFICATIONG_SMART_GC
     if (result) {
         NotifyObserverVipDoneBase();
     }
 #endif
+    return removed;
+}
+
+bool EventQueueBase::DiscardEventsLocked(const EventIndexLink *chain, const IndexFilter &filter,
+    std::list<InnerEvent::Pointer> &releaseEvents)
+{
+    // Collect events at first, since discarding an event unlinks it from the chain.
+    std::vector<InnerEvent *> events;
+    EventIndex::Visit(chain, [&filter, &events](InnerEvent &event) {
+        if (!filter || filter(event)) {
+            events.emplace_back(&event);
+        }
+        return false;
+    });
+
+    for (InnerEvent *event : events) {
+        // Discarded event may be dropped by its queue at once, so read all the information before that.
+        uint32_t priority = static_cast<uint32_t>(event->GetEventPriority());
+        EventLocation location = EventIndex::GetLocation(*event);
+        auto payload = eventIndex_.Discard(*event);
+        if (payload) {
+            releaseEvents.emplace_back(std::move(payload));
+        }
+        if (location == EventLocation::PICKED) {
+            // Dropped while the runner takes it.
+            continue;
+        }
+        if ((location == EventLocation::TIMING_WHEEL) && timingWheel_) {
+            timingWheel_->MarkDiscarded(priority);
+        } else if (priority == static_cast<uint32_t>(Priority::IDLE)) {
+            idleEvents_.MarkDiscarded();
+        } else if (priority < SUB_EVENT_QUEUE_NUM) {
+            SubEventQueue &subQueue = subEventQueues_[priority];
+            subQueue.queue.MarkDiscarded();
+            subQueue.frontEventHandleTime = GetFrontEventHandleTimeLocked(subQueue.queue);
+        }
+    }
+    return !events.empty();
 }
 
 void EventQueueBase::RemoveOrphan(const RemoveFilter &filter)
 {
-    std::list<InnerEvent::Pointer> releaseIdleEvents;
-    std::array<SubEventQueue, SUB_EVENT_QUEUE_NUM> releaseEventsQueue;
+    // Release events out of the lock.
+    std::list<InnerEvent::Pointer> releaseEvents;
     {
         LockGuardBase lock(*queueLock_);
         if (!usable_.load()) {
             HILOGW("EventQueueBase is unavailable.");
             return;
         }
+        DrainIngressLocked();
+        ReturnPickedEventsLocked();
 #ifdef NOTIFICATIONG_SMART_GC
         bool result = HasVipTask();
 #endif
         for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
-            auto it = std::stable_partition(subEventQueues_[i].queue.begin(), subEventQueues_[i].queue.end(), filter);
-            std::move(subEventQueues_[i].queue.begin(), it, std::back_inserter(releaseEventsQueue[i].queue));
-            subEventQueues_[i].queue.erase(subEventQueues_[i].queue.begin(), it);
-            subEventQueues_[i].frontEventHandleTime = (subEventQueues_[i].queue.size() ?
-            static_cast<uint64_t>((*subEventQueues_[i].queue.begin())
-            ->GetHandleTime().time_since_epoch().count()) : UINT64_MAX);
-        }
-        auto idleEventIt = std::stable_partition(idleEvents_.begin(), idleEvents_.end(), filter);
-        std::move(idleEvents_.begin(), idleEventIt, std::back_inserter(releaseIdleEvents));
-        idleEvents_.erase(idleEvents_.begin(), idleEventIt);
+            subEventQueues_[i].queue.MoveIf(filter, releaseEvents);
+            subEventQueues_[i].frontEventHandleTime = GetFrontEventHandleTimeLocked(subEventQueues_[i].queue);
+        }
+        idleEvents_.MoveIf(filter, releaseEvents);
+        if (timingWheel_) {
+            timingWheel_->MoveIf(filter, releaseEvents);
+        }
+        for (auto &event : releaseEvents) {
+            eventIndex_.Erase(*event);
+        }
 #ifdef NOTIFICATIONG_SMART_GC
         if (result) {
             NotifyObserverVipDoneBase();
@@ -406,16 +586,49 @@ void EventQueueBase::RemoveOrphan(const RemoveFilter &filter)
     }
 }
 
+void EventQueueBase::RemoveOrphanByOwnerId(uint64_t ownerId)
+{
+    HILOGD("enter");
+    // Declared before the lock, so that events are released out of it.
+    std::list<InnerEvent::Pointer> releaseEvents;
+    QueueLockGuard lock(lockType_, *queueLock_);
+    if (!usable_.load()) {
+        HILOGW("RemoveOrphanByOwnerId EventQueueBase is unavailable.");
+        return;
+    }
+    DrainIngressLocked();
+#ifdef NOTIFICATIONG_SMART_GC
+    bool result = HasVipTask();
+#endif
+    auto filter = [this](InnerEvent &event) {
+        if (event.IsVsyncTask()) {
+            HandleVsyncTaskNotify();
+            SetBarrierMode(false);
+            needEpoll_ = false;
+        }
+        return true;
+    };
+    DiscardEventsLocked(eventIndex_.FindOwner(ownerId), filter, releaseEvents);
+#ifdef NOTIFICATIONG_SMART_GC
+    if (result) {
+        NotifyObserverVipDoneBase();
+    }
+#endif
+    RemoveInvalidFileDescriptor();
+    PruneCoalescedFileDescriptorEventsLocked();
+}
+
 bool EventQueueBase::HasInnerEvent(const std::shared_ptr<EventHandler> &owner, uint32_t innerEventId)
 {
     if (!owner) {
         HILOGE("Invalid owner");
         return false;
     }
-    auto filter = [&owner, innerEventId](const InnerEvent::Pointer &p) {
-        return (!p->HasTask()) && (p->GetOwner() == owner) && (p->GetInnerEventId() == innerEventId);
+    uint64_t ownerId = owner->GetHandlerNumericId();
+    auto finder = [ownerId, innerEventId](const EventIndex &index) {
+        return index.FindEventId(ownerId, innerEventId);
     };
-    return HasInnerEvent(filter);
+    return HasInnerEvent(finder, nullptr);
 }
 
 bool EventQueueBase::HasInnerEvent(const std::shared_ptr<EventHandler> &owner, int64_t param)
@@ -424,30 +637,23 @@ bool EventQueueBase::HasInnerEvent(const std::shared_ptr<EventHandler> &owner, i
         HILOGE("Invalid owner");
         return false;
     }
-    auto filter = [&owner, param](const InnerEvent::Pointer &p) {
-        return (!p->HasTask()) && (p->GetOwner() == owner) && (p->GetParam() == param);
-    };
-    return HasInnerEvent(filter);
+    uint64_t ownerId = owner->GetHandlerNumericId();
+    auto finder = [ownerId](const EventIndex &index) { return index.FindOwner(ownerId); };
+    auto filter = [param](InnerEvent &event) { return (!event.HasTask()) && (event.GetParam() == param); };
+    return HasInnerEvent(finder, filter);
 }
 
-bool EventQueueBase::HasInnerEvent(const HasFilter &filter)
+bool EventQueueBase::HasInnerEvent(const IndexFinder &finder, const IndexFilter &filter)
 {
-    LockGuardBase lock(*queueLock_);
+    QueueLockGuard lock(lockType_, *queueLock_);
     if (!usable_.load()) {
         HILOGW("EventQueueBase is unavailable.");
         return false;
     }
-    for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
-        std::list<InnerEvent::Pointer>::iterator iter =
-            std::find_if(subEventQueues_[i].queue.begin(), subEventQueues_[i].queue.end(), filter);
-        if (iter != subEventQueues_[i].queue.end()) {
-            return true;
-        }
-    }
-    if (std::find_if(idleEvents_.begin(), idleEvents_.end(), filter) != idleEvents_.end()) {
-        return true;
-    }
-    return false;
+    DrainIngressLocked();
+    return EventIndex::Visit(finder(eventIndex_), [&filter](InnerEvent &event) {
+        return !filter || filter(event);
+    });
 }
 
 InnerEvent::Pointer EventQueueBase::PickFirstVsyncEventLocked()
@@ -456,13 +662,11 @@ InnerEvent::Pointer EventQueueBase::PickFirstVsyncEventLocked()
     auto filter = [](const InnerEvent::Pointer &p) {
         return p->IsVsyncTask();
     };
-    std::list<InnerEvent::Pointer>::iterator iter = std::find_if(events.begin(), events.end(), filter);
-    if (iter != events.end()) {
-        std::list<InnerEvent::Pointer> tempList;
-        tempList.splice(tempList.begin(), events, iter);
-        return PopFrontEventFromListLocked(tempList);
+    auto event = events.PopFirst(filter);
+    if (event) {
+        eventIndex_.Erase(*event);
     }
-    return InnerEvent::Pointer(nullptr, nullptr);
+    return event;
 }
 
 InnerEvent::Pointer EventQueueBase::PickEventLocked(const InnerEvent::TimePoint &now,
@@ -513,19 +717,229 @@ InnerEvent::Pointer EventQueueBase::PickEventLocked(const InnerEvent::TimePoint
     if (isBarrierMode) {
         return PopFrontBarrierEventFromListLocked(subEventQueues_[priorityIndex].queue);
     }
-    return PopFrontEventFromListLocked(subEventQueues_[priorityIndex].queue);
+    return subEventQueues_[priorityIndex].queue.PopFront();
+}
+
+void EventQueueBase::PickBatchLocked(const InnerEvent::TimePoint &now)
+{
+    // The first event has been picked, pick more by the same rules as picking them one by one right now.
+    pickedEvents_.clear();
+    pickedHandledCounts_.clear();
+    pickedIndex_ = 0;
+    pickedPriorityBound_ = 0;
+    while (pickedEvents_.size() + 1 < pickBatchSize_) {
+        HandledCounts handledCounts;
+        for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
+            handledCounts[i] = subEventQueues_[i].handledEventsCount;
+        }
+        InnerEvent::TimePoint nextWakeUpTime = InnerEvent::TimePoint::max();
+        auto event = PickEventLocked(now, nextWakeUpTime);
+        if (!event) {
+            break;
+        }
+        uint32_t priority = static_cast<uint32_t>(event->GetEventPriority());
+        SubEventQueue &subQueue = subEventQueues_[priority];
+        if (priority == static_cast<uint32_t>(Priority::VIP)) {
+            // VIP events are observed while they are queued, leave them to be picked one by one.
+            subQueue.queue.Insert(event, EventInsertType::AT_FRONT);
+            RestoreHandledCountsLocked(handledCounts);
+            break;
+        }
+        subQueue.frontEventHandleTime = GetFrontEventHandleTimeLocked(subQueue.queue);
+        // Keep it in indexes, so that it is still found by removing and querying.
+        EventIndex::SetLocation(*event, EventLocation::PICKED);
+        pickedPriorityBound_ = std::max(pickedPriorityBound_, priority);
+        pickedEvents_.emplace_back(std::move(event));
+        pickedHandledCounts_.emplace_back(handledCounts);
+    }
+}
+
+InnerEvent::Pointer EventQueueBase::TakePickedEventLocked()
+{
+    // Events posted through ingress queue may be distributed before picked ones.
+    DrainIngressLocked();
+    if (isBarrierMode_ || sumOfPendingVsync_ || needEpoll_) {
+        // Let vsync and barrier rules decide again.
+        ReturnPickedEventsLocked();
+        return InnerEvent::Pointer(nullptr, nullptr);
+    }
+    InnerEvent::Pointer event(nullptr, nullptr);
+    while (!event && (pickedIndex_ < pickedEvents_.size())) {
+        event = std::move(pickedEvents_[pickedIndex_++]);
+        if (EventIndex::IsDiscarded(*event)) {
+            // Removed after picked.
+            event.reset();
+        }
+    }
+    if (pickedIndex_ >= pickedEvents_.size()) {
+        pickedEvents_.clear();
+        pickedHandledCounts_.clear();
+        pickedIndex_ = 0;
+    }
+    if (event) {
+        eventIndex_.Erase(*event);
+        isIdle_ = false;
+        currentRunningEvent_ = CurrentRunningEvent(InnerEvent::Clock::now(), event);
+    }
+    return event;
+}
+
+void EventQueueBase::ReturnPickedEventsLocked()
+{
+    if (pickedIndex_ >= pickedEvents_.size()) {
+        return;
+    }
+    // Counts of continuously handled events are restored as if the rest were never picked.
+    RestoreHandledCountsLocked(pickedHandledCounts_[pickedIndex_]);
+    // Insert at front in reverse order, so that they are still ahead of other events in order of picking.
+    for (size_t i = pickedEvents_.size(); i > pickedIndex_; --i) {
+        auto &event = pickedEvents_[i - 1];
+        if (EventIndex::IsDiscarded(*event)) {
+            continue;
+        }
+        SubEventQueue &subQueue = subEventQueues_[static_cast<uint32_t>(event->GetEventPriority())];
+        subQueue.queue.Insert(event, EventInsertType::AT_FRONT);
+        subQueue.frontEventHandleTime = GetFrontEventHandleTimeLocked(subQueue.queue);
+    }
+    pickedEvents_.clear();
+    pickedHandledCounts_.clear();
+    pickedIndex_ = 0;
+}
+
+void EventQueueBase::RestoreHandledCountsLocked(const HandledCounts &handledCounts)
+{
+    for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
+        subEventQueues_[i].handledEventsCount = handledCounts[i];
+    }
+}
+
+InnerEvent::Pointer EventQueueBase::PickPooledEventLocked(const InnerEvent::TimePoint &now,
+    InnerEvent::TimePoint &nextWakeUpTime)
+{
+    // Events of busy handlers are skipped, their workers take them after finishing the current ones.
+    auto filter = [this, &now, &nextWakeUpTime](const InnerEvent::Pointer &event) {
+        const auto &handleTime = event->GetHandleTime();
+        if (handleTime > now) {
+            nextWakeUpTime = std::min(nextWakeUpTime, handleTime);
+            return false;
+        }
+        return busyHandlers_.find(event->GetOwnerNumericId()) == busyHandlers_.end();
+    };
+    for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
+        SortedEventQueue &queue = subEventQueues_[i].queue;
+        if (queue.Empty()) {
+            continue;
+        }
+        if (filter(queue.Front())) {
+            return queue.PopFront();
+        }
+        if (queue.Front()->GetHandleTime() > now) {
+            continue;
+        }
+        auto event = queue.PopFirst(filter);
+        if (event) {
+            return event;
+        }
+    }
+    return InnerEvent::Pointer(nullptr, nullptr);
+}
+
+bool EventQueueBase::HasPooledEventLocked(const InnerEvent::TimePoint &now)
+{
+    auto filter = [this, &now](const InnerEvent::Pointer &event) {
+        return (event->GetHandleTime() <= now) &&
+            (busyHandlers_.find(event->GetOwnerNumericId()) == busyHandlers_.end());
+    };
+    for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
+        const SortedEventQueue &queue = subEventQueues_[i].queue;
+        if (queue.Empty() || (queue.Front()->GetHandleTime() > now)) {
+            continue;
+        }
+        if (filter(queue.Front()) || queue.HasIf(filter)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EventQueueBase::IsStealableOnInsert(const InnerEvent::Pointer &event, Priority priority) const
+{
+    // Delayed tasks are only taken by peers which look for events by themselves, nobody is notified for them.
+    return !stealingGroup_.expired() && ((priority == Priority::LOW) || (priority == Priority::IDLE)) &&
+        event->HasTask() && !event->IsThreadAffine() && (event->GetHandleTime() <= event->GetSendTime());
+}
+
+InnerEvent::Pointer EventQueueBase::PopStealableEventLocked(const InnerEvent::TimePoint &now)
+{
+    // Events handled by 'ProcessEvent' of handlers may rely on the thread of runner, only tasks are stolen.
+    auto filter = [&now](const InnerEvent::Pointer &event) {
+        return (event->GetHandleTime() <= now) && event->HasTask() && !event->IsThreadAffine();
+    };
+    for (SortedEventQueue *queue : {&subEventQueues_[static_cast<uint32_t>(Priority::LOW)].queue, &idleEvents_}) {
+        if (queue->Empty() || (queue->Front()->GetHandleTime() > now)) {
+            continue;
+        }
+        if (filter(queue->Front())) {
+            return queue->PopFront();
+        }
+        auto event = queue->PopFirst(filter);
+        if (event) {
+            return event;
+        }
+    }
+    return InnerEvent::Pointer(nullptr, nullptr);
+}
+
+bool EventQueueBase::HasStealableEventLocked(const InnerEvent::TimePoint &now)
+{
+    auto filter = [&now](const InnerEvent::Pointer &event) {
+        return (event->GetHandleTime() <= now) && event->HasTask() && !event->IsThreadAffine();
+    };
+    for (const SortedEventQueue *queue :
+        {&subEventQueues_[static_cast<uint32_t>(Priority::LOW)].queue, &idleEvents_}) {
+        if (queue->Empty() || (queue->Front()->GetHandleTime() > now)) {
+            continue;
+        }
+        if (filter(queue->Front()) || queue->HasIf(filter)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventQueueBase::MoveExpiredTimersLocked(const InnerEvent::TimePoint &now)
+{
+    std::list<TimingWheel::Entry> expired;
+    timingWheel_->Advance(now, expired);
+    for (auto &entry : expired) {
+        SubEventQueue &subQueue = subEventQueues_[entry.priority];
+        subQueue.queue.Insert(entry.event);
+        subQueue.frontEventHandleTime = GetFrontEventHandleTimeLocked(subQueue.queue);
+    }
 }
 
 InnerEvent::Pointer EventQueueBase::GetExpiredEventLocked(InnerEvent::TimePoint &nextExpiredTime)
 {
+    DrainIngressLocked();
     auto now = InnerEvent::Clock::now();
     wakeUpTime_ = InnerEvent::TimePoint::max();
+    if (timingWheel_) {
+        // Sort events which are about to expire into sub event queues.
+        MoveExpiredTimersLocked(now);
+    }
     // Find an event which could be distributed right now.
-    InnerEvent::Pointer event = PickEventLocked(now, wakeUpTime_);
+    InnerEvent::Pointer event = workerPool_ ? PickPooledEventLocked(now, wakeUpTime_) :
+        PickEventLocked(now, wakeUpTime_);
+    if (timingWheel_) {
+        wakeUpTime_ = std::min(wakeUpTime_, timingWheel_->GetNextExpireTime());
+    }
     if (event) {
+        if (workerPool_ && (event->GetOwnerNumericId() != 0)) {
+            busyHandlers_.insert(event->GetOwnerNumericId());
+        }
+        eventIndex_.Erase(*event);
         int32_t prio = event->GetEventPriority();
-        subEventQueues_[prio].frontEventHandleTime = subEventQueues_[prio].queue.empty() ? UINT64_MAX :
-            static_cast<uint64_t>((*subEventQueues_[prio].queue.begin())->GetHandleTime().time_since_epoch().count());
+        subEventQueues_[prio].frontEventHandleTime = GetFrontEventHandleTimeLocked(subEventQueues_[prio].queue);
         // Exit idle mode, if found an event to distribute.
         isIdle_ = false;
         currentRunningEvent_ = CurrentRunningEvent(now, event);
@@ -538,19 +952,25 @@ InnerEvent::Pointer EventQueueBase::GetExpiredEventLocked(InnerEvent::TimePoint
         isIdle_ = true;
     }
 
-    if (!idleEvents_.empty()) {
+    if (!idleEvents_.Empty()) {
         if (isBarrierMode_) {
             event = PopFrontBarrierEventFromListWithTimeLocked(idleEvents_, idleTimeStamp_, now);
             if (event) {
+                eventIndex_.Erase(*event);
                 currentRunningEvent_ = CurrentRunningEvent(now, event);
                 return event;
             }
         } else {
-            const auto &idleEvent = idleEvents_.front();
+            const auto &idleEvent = idleEvents_.Front();
 
             // Return the idle event that has been sent before time stamp and reaches its handle time.
-            if ((idleEvent->GetSendTime() <= idleTimeStamp_) && (idleEvent->GetHandleTime() <= now)) {
-                event = PopFrontEventFromListLocked(idleEvents_);
+            if ((idleEvent->GetSendTime() <= idleTimeStamp_) && (idleEvent->GetHandleTime() <= now) &&
+                (busyHandlers_.find(idleEvent->GetOwnerNumericId()) == busyHandlers_.end())) {
+                event = idleEvents_.PopFront();
+                if (workerPool_ && (event->GetOwnerNumericId() != 0)) {
+                    busyHandlers_.insert(event->GetOwnerNumericId());
+                }
+                eventIndex_.Erase(*event);
                 currentRunningEvent_ = CurrentRunningEvent(now, event);
                 return event;
             }
@@ -598,16 +1018,48 @@ void EventQueueBase::CheckBarrierMode()
 InnerEvent::Pointer EventQueueBase::GetEvent()
 {
     UniqueLockBase lock(*queueLock_);
+    // Runner in stealing group is announced idle while looking for events of peers and sleeping.
+    IdleAnnouncement idle;
+    bool stealTried = false;
+    uint64_t notifiedCount = 0;
     while (!finished_) {
+        if (__builtin_expect(!directFileDescriptorEvents_.empty(), 0) &&
+            DispatchDirectFileDescriptorEventsLocked(lock)) {
+            // Lock was released while calling listeners.
+            continue;
+        }
+        if (pickedIndex_ < pickedEvents_.size()) {
+            auto event = TakePickedEventLocked();
+            if (event) {
+                return event;
+            }
+        }
         CheckBarrierMode();
         InnerEvent::TimePoint nextWakeUpTime = InnerEvent::TimePoint::max();
         InnerEvent::Pointer event = GetExpiredEventLocked(nextWakeUpTime);
         if (event) {
             auto now = InnerEvent::Clock::now();
-            if (!isLazyMode_.load() && !sumOfPendingVsync_ && (needEpoll_ || vsyncCheckTime_ <
+            if (workerPool_ && (sleepingCount_ > 0) && HasPooledEventLocked(now)) {
+                // Let another worker take the rest.
+                NotifyOneLocked();
+            }
+            // Polling for vsync would take the wakeup of another worker of pool.
+            if (!workerPool_ && !isLazyMode_.load() && !sumOfPendingVsync_ && (needEpoll_ || vsyncCheckTime_ <
                 std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count())) {
                 TryEpollFd(now, lock);
             }
+            auto group = stealingGroup_.lock();
+            if ((pickBatchSize_ > 1) && !workerPool_ && !group && !isBarrierMode_ && !sumOfPendingVsync_ &&
+                !needEpoll_ && (event->GetEventPriority() != static_cast<int32_t>(Priority::IDLE))) {
+                PickBatchLocked(now);
+            }
+            if (group && HasStealableEventLocked(now)) {
+                // Let an idle peer take the rest, the group locks peers so release the lock first.
+                uint32_t index = stealingIndex_;
+                lock.unlock();
+                idle.Withdraw();
+                group->NotifyStealable(index);
+            }
             return event;
         } else if (__builtin_expect(sumOfPendingVsync_, 0)) {
             auto event = PickFirstVsyncEventLocked();
@@ -621,8 +1073,39 @@ InnerEvent::Pointer EventQueueBase::GetEvent()
             SetBarrierMode(false);
             continue;
         }
+        auto group = stealingGroup_.lock();
+        if (group && (!stealTried || (group->GetNotifiedCount() != notifiedCount))) {
+            // Look again if notified after looking, otherwise sleep until woken up.
+            idle.Announce(group);
+            stealTried = true;
+            notifiedCount = group->GetNotifiedCount();
+            event = StealFromPeers(group, lock);
+            if (event) {
+                return event;
+            }
+            // Events may be inserted while the lock is released.
+            continue;
+        }
+        bool busyPolled = false;
+        if ((busyPollTime_.count() > 0) && !workerPool_) {
+            if (BusyPollLocked(nextWakeUpTime, lock)) {
+                continue;
+            }
+            busyPolled = true;
+        }
+        if (ingressQueue_ && !ingressQueue_->PrepareWait()) {
+            // Events are posted after picking, take them in instead of waiting.
+            continue;
+        }
+        if (busyPolled) {
+            busyPollParkCount_.fetch_add(1, std::memory_order_relaxed);
+        }
         TryExecuteObserverCallback(nextWakeUpTime, EventRunnerStage::STAGE_BEFORE_WAITING);
-        WaitUntilLocked(nextWakeUpTime, lock);
+        SleepUntilLocked(nextWakeUpTime, lock);
+        if (ingressQueue_) {
+            ingressQueue_->FinishWait();
+        }
+        stealTried = false;
         needEpoll_ = false;
         TryExecuteObserverCallback(nextWakeUpTime, EventRunnerStage::STAGE_AFTER_WAITING);
     }
@@ -712,9 +1195,118 @@ void EventQueueBase::ClearObserver()
 InnerEvent::Pointer EventQueueBase::GetExpiredEvent(InnerEvent::TimePoint &nextExpiredTime)
 {
     UniqueLockBase lock(*queueLock_);
+    if (__builtin_expect(!directFileDescriptorEvents_.empty(), 0)) {
+        (void)DispatchDirectFileDescriptorEventsLocked(lock);
+    }
+    // Events picked by 'GetEvent' go first.
+    ReturnPickedEventsLocked();
     return GetExpiredEventLocked(nextExpiredTime);
 }
 
+bool EventQueueBase::PushDirectFileDescriptorEvent(int32_t fileDescriptor, uint32_t events, Priority priority,
+    const std::shared_ptr<FileDescriptorListener> &listener)
+{
+    if (workerPool_) {
+        // Listeners are called by tasks, so that they are serialized with other events of their handlers.
+        return false;
+    }
+    // Called by the running thread while waiting, so it sees the event as soon as it wakes up.
+    LockGuardBase lock(*queueLock_);
+    directFileDescriptorEvents_.push_back({fileDescriptor, events, priority, listener});
+    return true;
+}
+
+bool EventQueueBase::CoalesceFileDescriptorEvent(int32_t fileDescriptor, uint32_t events)
+{
+    LockGuardBase lock(*queueLock_);
+    auto &coalesced = coalescedFileDescriptorEvents_[fileDescriptor];
+    if (!coalesced.pending) {
+        coalesced.pending = true;
+        coalesced.events = events;
+        return false;
+    }
+    coalesced.events |= events;
+    ++coalesced.coalescedCount;
+    return true;
+}
+
+uint32_t EventQueueBase::TakeCoalescedFileDescriptorEvents(int32_t fileDescriptor, uint32_t events)
+{
+    // Events reported from now on need another call, since the listener may have read all data already.
+    LockGuardBase lock(*queueLock_);
+    auto it = coalescedFileDescriptorEvents_.find(fileDescriptor);
+    if (it == coalescedFileDescriptorEvents_.end() || !it->second.pending) {
+        return events;
+    }
+    uint32_t allEvents = it->second.events | events;
+    it->second.pending = false;
+    it->second.events = 0;
+    return allEvents;
+}
+
+void EventQueueBase::PruneCoalescedFileDescriptorEventsLocked()
+{
+    for (auto it = coalescedFileDescriptorEvents_.begin(); it != coalescedFileDescriptorEvents_.end();) {
+        if (listeners_.find(it->first) == listeners_.end()) {
+            it = coalescedFileDescriptorEvents_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+bool EventQueueBase::HasExpiredEventLocked(Priority priority, const InnerEvent::TimePoint &now) const
+{
+    uint32_t last = std::min(static_cast<uint32_t>(priority), SUB_EVENT_QUEUE_NUM - 1);
+    for (uint32_t prio = 0; prio <= last; ++prio) {
+        const auto &queue = subEventQueues_[prio].queue;
+        if (!queue.Empty() && (queue.Front()->GetHandleTime() <= now)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool EventQueueBase::DispatchDirectFileDescriptorEventsLocked(UniqueLockBase &lock)
+{
+    DrainIngressLocked();
+    auto now = InnerEvent::Clock::now();
+    if (timingWheel_) {
+        MoveExpiredTimersLocked(now);
+    }
+
+    // Expired events with the same or higher priority are distributed first, as if a task was posted.
+    auto deferred = std::stable_partition(directFileDescriptorEvents_.begin(), directFileDescriptorEvents_.end(),
+        [this, &now](const DirectFileDescriptorEvent &fdEvent) {
+            return HasExpiredEventLocked(fdEvent.priority, now);
+        });
+    if (deferred == directFileDescriptorEvents_.end()) {
+        return false;
+    }
+    std::vector<DirectFileDescriptorEvent> fdEvents(std::make_move_iterator(deferred),
+        std::make_move_iterator(directFileDescriptorEvents_.end()));
+    directFileDescriptorEvents_.erase(deferred, directFileDescriptorEvents_.end());
+
+    lock.unlock();
+    for (const auto &fdEvent : fdEvents) {
+        auto listener = fdEvent.listener.lock();
+        if (!listener) {
+            HILOGW("Listener is released");
+            continue;
+        }
+        uint32_t events = fdEvent.events;
+        if ((events & FILE_DESCRIPTOR_COALESCED) != 0) {
+            events = TakeCoalescedFileDescriptorEvents(fdEvent.fileDescriptor, events);
+        }
+        NotifyFileDescriptorListener(listener, fdEvent.fileDescriptor, events);
+        if ((fdEvent.events & FILE_DESCRIPTOR_ONESHOT) != 0) {
+            RearmFileDescriptorListener(fdEvent.fileDescriptor);
+        }
+    }
+    lock.lock();
+    return true;
+}
+
 void EventQueueBase::DumpCurrentRunningEventId(const InnerEvent::EventId &innerEventId, std::string &content)
 {
     if (innerEventId.index() == TYPE_U32_INDEX) {
@@ -745,7 +1337,7 @@ std::string EventQueueBase::DumpCurrentRunning()
             if (currentRunningEvent_.param_ != 0) {
                 content.append(", param = " + std::to_string(currentRunningEvent_.param_));
             }
-            content.append(", caller = " + currentRunningEvent_.callerInfo_);
+            content.append(", caller = " + currentRunningEvent_.caller_.ToString());
         } else {
             content.append("No handler");
         }
@@ -763,25 +1355,29 @@ void EventQueueBase::DumpCurentQueueInfo(Dumper &dumper, uint32_t dumpMaxSize)
         uint32_t n = 0;
         dumper.Dump(dumper.GetTag() + " " + priority[i] + " priority event queue information:" +
             std::string(LINE_SEPARATOR));
-        for (auto it = subEventQueues_[i].queue.begin(); it != subEventQueues_[i].queue.end(); ++it) {
+        auto dumpEvent = [&dumper, &n, &total, dumpMaxSize](const InnerEvent::Pointer &event) {
             ++n;
             if (total < dumpMaxSize) {
-                dumper.Dump(dumper.GetTag() + " No." + std::to_string(n) + " : " + (*it)->Dump());
+                dumper.Dump(dumper.GetTag() + " No." + std::to_string(n) + " : " + event->Dump());
             }
             ++total;
+        };
+        subEventQueues_[i].queue.ForEach(dumpEvent);
+        if (timingWheel_) {
+            timingWheel_->ForEach(i, dumpEvent);
         }
         dumper.Dump(dumper.GetTag() + " Total size of " + priority[i] + " events : " + std::to_string(n) +
             std::string(LINE_SEPARATOR));
     }
     dumper.Dump(dumper.GetTag() + " Idle priority event queue information:" + std::string(LINE_SEPARATOR));
     int n = 0;
-    for (auto it = idleEvents_.begin(); it != idleEvents_.end(); ++it) {
+    idleEvents_.ForEach([&dumper, &n, &total, dumpMaxSize](const InnerEvent::Pointer &event) {
         ++n;
         if (total < dumpMaxSize) {
-            dumper.Dump(dumper.GetTag() + " No." + std::to_string(n) + " : " + (*it)->Dump());
+            dumper.Dump(dumper.GetTag() + " No." + std::to_string(n) + " : " + event->Dump());
         }
         ++total;
-    }
+    });
     dumper.Dump(dumper.GetTag() + " Total size of Idle events : " + std::to_string(n) + std::string(LINE_SEPARATOR));
     dumper.Dump(dumper.GetTag() + " Total event size : " + std::to_string(total) + std::string(LINE_SEPARATOR));
 }
@@ -794,6 +1390,8 @@ void EventQueueBase::Dump(Dumper &dumper)
         HILOGW("EventQueueBase is unavailable.");
         return;
     }
+    DrainIngressLocked();
+    ReturnPickedEventsLocked();
     dumper.Dump(dumper.GetTag() + " Current Running: " + DumpCurrentRunning() + std::string(LINE_SEPARATOR));
     dumper.Dump(dumper.GetTag() + " History event queue information:" + std::string(LINE_SEPARATOR));
     uint32_t dumpMaxSize = MAX_DUMP_SIZE;
@@ -815,15 +1413,21 @@ void EventQueueBase::DumpQueueInfo(std::string& queueInfo)
         HILOGW("EventQueueBase is unavailable.");
         return;
     }
+    DrainIngressLocked();
+    ReturnPickedEventsLocked();
     std::string priority[] = {"VIP", "Immediate", "High", "Low"};
     uint32_t total = 0;
     for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
         uint32_t n = 0;
         queueInfo +=  "            " + priority[i] + " priority event queue:" + std::string(LINE_SEPARATOR);
-        for (auto it = subEventQueues_[i].queue.begin(); it != subEventQueues_[i].queue.end(); ++it) {
+        auto dumpEvent = [&queueInfo, &n, &total](const InnerEvent::Pointer &event) {
             ++n;
-            queueInfo +=  "            No." + std::to_string(n) + " : " + (*it)->Dump();
+            queueInfo +=  "            No." + std::to_string(n) + " : " + event->Dump();
             ++total;
+        };
+        subEventQueues_[i].queue.ForEach(dumpEvent);
+        if (timingWheel_) {
+            timingWheel_->ForEach(i, dumpEvent);
         }
         queueInfo +=  "              Total size of " + priority[i] + " events : " + std::to_string(n) +
             std::string(LINE_SEPARATOR);
@@ -832,11 +1436,11 @@ void EventQueueBase::DumpQueueInfo(std::string& queueInfo)
     queueInfo += "            Idle priority event queue:" + std::string(LINE_SEPARATOR);
  
     int n = 0;
-    for (auto it = idleEvents_.begin(); it != idleEvents_.end(); ++it) {
+    idleEvents_.ForEach([&queueInfo, &n, &total](const InnerEvent::Pointer &event) {
         ++n;
-        queueInfo += "            No." + std::to_string(n) + " : " + (*it)->Dump();
+        queueInfo += "            No." + std::to_string(n) + " : " + event->Dump();
         ++total;
-    }
+    });
     queueInfo += "              Total size of Idle events : " + std::to_string(n) + std::string(LINE_SEPARATOR);
     queueInfo += "            Total event size : " + std::to_string(total);
 }
@@ -853,14 +1457,15 @@ bool EventQueueBase::IsQueueEmpty()
         HILOGW("EventQueueBase is unavailable.");
         return false;
     }
+    DrainIngressLocked();
+    ReturnPickedEventsLocked();
     for (uint32_t i = 0; i < SUB_EVENT_QUEUE_NUM; ++i) {
-        uint32_t queueSize = subEventQueues_[i].queue.size();
-        if (queueSize != 0) {
+        if (!IsSubEventQueueEmptyLocked(i)) {
             return false;
         }
     }
  
-    return idleEvents_.size() == 0;
+    return idleEvents_.Empty();
 }
  
 void EventQueueBase::PushHistoryQueueBeforeDistribute(const InnerEvent::Pointer &event)
@@ -876,7 +1481,7 @@ void EventQueueBase::PushHistoryQueueBeforeDistribute(const InnerEvent::Pointer
     historyEvents_[historyEventIndex_].triggerTime = InnerEvent::Clock::now();
     historyEvents_[historyEventIndex_].priority = event->GetEventPriority();
     historyEvents_[historyEventIndex_].completeTime = InnerEvent::TimePoint::max();
-    historyEvents_[historyEventIndex_].callerInfo_ = (event->GetCaller()).ToString();
+    historyEvents_[historyEventIndex_].caller_ = event->GetCaller();
     currentRunningEvent_.triggerTime_ = InnerEvent::Clock::now();
 
     if (event->HasTask()) {
@@ -922,7 +1527,7 @@ std::string EventQueueBase::HistoryQueueDump(const HistoryEvent &historyEvent)
     } else {
         DumpCurrentRunningEventId(historyEvent.innerEventId, content);
     }
-    content.append(", caller = " + historyEvent.callerInfo_);
+    content.append(", caller = " + historyEvent.caller_.ToString());
     content.append(" }" + std::string(LINE_SEPARATOR));
 
     return content;
@@ -930,24 +1535,30 @@ std::string EventQueueBase::HistoryQueueDump(const HistoryEvent &historyEvent)
  
 std::string EventQueueBase::DumpCurrentQueueSize()
 {
-    return "Current queue size: VIP = " +
-    std::to_string(subEventQueues_[static_cast<int>(Priority::VIP)].queue.size()) + ", IMMEDIATE = " +
-    std::to_string(subEventQueues_[static_cast<int>(Priority::IMMEDIATE)].queue.size()) + ", HIGH = " +
-    std::to_string(subEventQueues_[static_cast<int>(Priority::HIGH)].queue.size()) + ", LOW = " +
-    std::to_string(subEventQueues_[static_cast<int>(Priority::LOW)].queue.size()) + ", IDLE = " +
-    std::to_string(idleEvents_.size()) + " ; ";
+    auto size = [this](Priority priority) {
+        uint32_t i = static_cast<uint32_t>(priority);
+        return std::to_string(subEventQueues_[i].queue.Size() + (timingWheel_ ? timingWheel_->Size(i) : 0));
+    };
+    return "Current queue size: VIP = " + size(Priority::VIP) + ", IMMEDIATE = " + size(Priority::IMMEDIATE) +
+        ", HIGH = " + size(Priority::HIGH) + ", LOW = " + size(Priority::LOW) + ", IDLE = " +
+        std::to_string(idleEvents_.Size()) + " ; ";
 }
 
 bool EventQueueBase::HasPreferEvent(int basePrio)
 {
     for (int prio = 0; prio < basePrio; prio++) {
-        if (subEventQueues_[prio].queue.size() > 0) {
+        if (!IsSubEventQueueEmptyLocked(static_cast<uint32_t>(prio))) {
             return true;
         }
     }
     return false;
 }
 
+bool EventQueueBase::IsSubEventQueueEmptyLocked(uint32_t priority) const
+{
+    return subEventQueues_[priority].queue.Empty() && (!timingWheel_ || (timingWheel_->Size(priority) == 0));
+}
+
 PendingTaskInfo EventQueueBase::QueryPendingTaskInfo(int32_t fileDescriptor)
 {
     PendingTaskInfo pendingTaskInfo;
@@ -967,23 +1578,29 @@ PendingTaskInfo EventQueueBase::QueryPendingTaskInfo(int32_t fileDescriptor)
         HILOGW("QueryPendingTaskInfo event queue is unavailable.");
         return pendingTaskInfo;
     }
+    DrainIngressLocked();
 
     auto now = InnerEvent::Clock::now();
-    for (auto it = subEventQueues_[0].queue.begin(); it != subEventQueues_[0].queue.end(); it++) {
-        if ((*it)->GetTaskName() == fileDescriptorInfo->taskName_) {
+    subEventQueues_[0].queue.ForEach([&pendingTaskInfo, &fileDescriptorInfo, &now](const InnerEvent::Pointer &event) {
+        if (event->GetTaskName() == fileDescriptorInfo->taskName_) {
             pendingTaskInfo.taskCount++;
-            InnerEvent::TimePoint handlerTime = (*it)->GetHandleTime();
+            InnerEvent::TimePoint handlerTime = event->GetHandleTime();
             if (handlerTime >= now) {
-                continue;
+                return;
             }
             auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - handlerTime).count();
             if (duration > pendingTaskInfo.MaxPendingTime) {
                 pendingTaskInfo.MaxPendingTime = duration;
             }
         }
-    }
-    EH_LOGI_LIMIT("Pend task %{public}d %{public}d", pendingTaskInfo.taskCount, pendingTaskInfo.MaxPendingTime);
-    return PendingTaskInfo();
+    });
+    auto coalesced = coalescedFileDescriptorEvents_.find(fileDescriptor);
+    if (coalesced != coalescedFileDescriptorEvents_.end()) {
+        pendingTaskInfo.coalescedCount = coalesced->second.coalescedCount;
+    }
+    EH_LOGI_LIMIT("Pend task %{public}d %{public}d %{public}d", pendingTaskInfo.taskCount,
+        pendingTaskInfo.MaxPendingTime, pendingTaskInfo.coalescedCount);
+    return pendingTaskInfo;
 }
 
 void EventQueueBase::CancelAndWait()
@@ -1004,7 +1621,7 @@ CurrentRunningEvent::CurrentRunningEvent(InnerEvent::TimePoint time, InnerEvent:
     sendTime_ = event->GetSendTime();
     handleTime_ = event->GetHandleTime();
     param_ = event->GetParam();
-    callerInfo_ = (event->GetCaller()).ToString();
+    caller_ = event->GetCaller();
     if (event->HasTask()) {
         hasTask_ = true;
         taskName_ = event->GetTaskName();
@@ -1023,8 +1640,17 @@ ErrCode EventQueueBase::AddFileDescriptorListener(int32_t fileDescriptor, uint32
         return EVENT_HANDLER_ERR_INVALID_PARAM;
     }
 
+    if (workerPool_) {
+        // Workers wait on epoll together, so that each readiness is reported to only one of them.
+        events |= FILE_DESCRIPTOR_ONESHOT;
+    }
     LockGuardBase lock(*queueLock_);
-    return AddFileDescriptorListenerBase(fileDescriptor, events, listener, taskName, priority);
+    // Listeners may be dropped while waiting, so merged events of the file descriptor may be left.
+    PruneCoalescedFileDescriptorEventsLocked();
+    auto result = AddFileDescriptorListenerBase(fileDescriptor, events, listener, taskName, priority);
+    // IO waiter may be replaced by one listening file descriptors.
+    ApplyWaitOptionsLocked();
+    return result;
 }
 
 void EventQueueBase::RemoveFileDescriptorListener(const std::shared_ptr<EventHandler> &owner)
@@ -1037,6 +1663,7 @@ void EventQueueBase::RemoveFileDescriptorListener(const std::shared_ptr<EventHan
 
     LockGuardBase lock(*queueLock_);
     RemoveListenerByOwner(owner);
+    PruneCoalescedFileDescriptorEventsLocked();
 }
 
 void EventQueueBase::RemoveFileDescriptorListener(int32_t fileDescriptor)
@@ -1048,6 +1675,7 @@ void EventQueueBase::RemoveFileDescriptorListener(int32_t fileDescriptor)
     }
 
     LockGuardBase lock(*queueLock_);
+    coalescedFileDescriptorEvents_.erase(fileDescriptor);
     RemoveListenerByFd(fileDescriptor);
 }
 
@@ -1063,6 +1691,7 @@ void EventQueueBase::Finish()
     HILOGD("enter");
     LockGuardBase lock(*queueLock_);
     FinishBase();
+    busyPollWoken_.store(true, std::memory_order_release);
 }
 
 void EventQueueBase::NotifyObserverVipDone(const InnerEvent::Pointer &event)
@@ -1075,7 +1704,7 @@ void EventQueueBase::NotifyObserverVipDone(const InnerEvent::Pointer &event)
 
 void EventQueueBase::NotifyObserverVipDoneBase()
 {
-    if (subEventQueues_[static_cast<uint32_t>(Priority::VIP)].queue.empty()) {
+    if (IsSubEventQueueEmptyLocked(static_cast<uint32_t>(Priority::VIP))) {
         InnerEvent::TimePoint time = InnerEvent::Clock::now();
         TryExecuteObserverCallback(time, EventRunnerStage::STAGE_VIP_NONE);
         isExistVipTask_ = false;
@@ -1084,7 +1713,7 @@ void EventQueueBase::NotifyObserverVipDoneBase()
 
 bool EventQueueBase::HasVipTask()
 {
-    if (!subEventQueues_[static_cast<uint32_t>(Priority::VIP)].queue.empty()) {
+    if (!IsSubEventQueueEmptyLocked(static_cast<uint32_t>(Priority::VIP))) {
         return true;
     }
     return false;
@@ -1121,5 +1750,227 @@ void EventQueueBase::SetUsable(bool usable)
 {
     usable_.store(usable);
 }
+
+void EventQueueBase::EnableTimingWheel()
+{
+    LockGuardBase lock(*queueLock_);
+    if (!timingWheel_) {
+        timingWheel_ = std::make_unique<TimingWheel>(InnerEvent::Clock::now());
+    }
+}
+
+void EventQueueBase::SetPickBatchSize(uint32_t maxCount)
+{
+    LockGuardBase lock(*queueLock_);
+    pickBatchSize_ = std::max(maxCount, 1u);
+    ReturnPickedEventsLocked();
+}
+
+void EventQueueBase::EnableWorkerPool()
+{
+    LockGuardBase lock(*queueLock_);
+    workerPool_ = true;
+}
+
+bool EventQueueBase::IsWorkerPool() const
+{
+    return workerPool_;
+}
+
+void EventQueueBase::EnableHighResolutionWait()
+{
+    LockGuardBase lock(*queueLock_);
+    highResolutionWait_ = true;
+    ApplyWaitOptionsLocked();
+}
+
+void EventQueueBase::SetMaxEventsPerWait(uint32_t maxEvents)
+{
+    LockGuardBase lock(*queueLock_);
+    maxEventsPerWait_ = maxEvents;
+    ApplyWaitOptionsLocked();
+}
+
+void EventQueueBase::ApplyWaitOptionsLocked()
+{
+    if (!ioWaiter_) {
+        return;
+    }
+    if (highResolutionWait_) {
+        ioWaiter_->EnableHighResolution();
+    }
+    ioWaiter_->SetMaxEventsPerWait(maxEventsPerWait_);
+}
+
+void EventQueueBase::SleepUntilLocked(const InnerEvent::TimePoint &when, UniqueLockBase &lock)
+{
+    // Producers notify only while a thread is sleeping, both sides see the state with the lock held.
+    ++sleepingCount_;
+    WaitUntilLocked(when, lock);
+    --sleepingCount_;
+    wakeupPending_ = false;
+}
+
+void EventQueueBase::NotifyOneLocked()
+{
+    if (busyPolling_) {
+        // Busy polling thread sees it without a system call.
+        busyPollWoken_.store(true, std::memory_order_release);
+        elidedWakeupCount_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    // An awake thread checks the queue again before sleeping, so only a sleeping one needs to be woken up.
+    if ((sleepingCount_ == 0) || wakeupPending_) {
+        elidedWakeupCount_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    wakeupPending_ = true;
+    issuedWakeupCount_.fetch_add(1, std::memory_order_relaxed);
+    ioWaiter_->NotifyOne();
+}
+
+void EventQueueBase::GetWakeupCounts(uint64_t &issuedCount, uint64_t &elidedCount) const
+{
+    issuedCount = issuedWakeupCount_.load(std::memory_order_relaxed);
+    elidedCount = elidedWakeupCount_.load(std::memory_order_relaxed);
+}
+
+void EventQueueBase::SetBusyPollTime(std::chrono::nanoseconds busyPollTime)
+{
+    LockGuardBase lock(*queueLock_);
+    busyPollTime_ = busyPollTime;
+}
+
+void EventQueueBase::GetBusyPollCounts(uint64_t &hitCount, uint64_t &parkCount) const
+{
+    hitCount = busyPollHitCount_.load(std::memory_order_relaxed);
+    parkCount = busyPollParkCount_.load(std::memory_order_relaxed);
+}
+
+void EventQueueBase::FinishDistribution(uint64_t ownerId)
+{
+    if (ownerId == 0) {
+        return;
+    }
+    // The worker takes the next event of the handler by itself, so nobody needs to be woken up.
+    LockGuardBase lock(*queueLock_);
+    busyHandlers_.erase(ownerId);
+}
+
+InnerEvent::Pointer EventQueueBase::StealFromPeers(const std::shared_ptr<StealingGroup> &group,
+    UniqueLockBase &lock)
+{
+    // Queues are never locked nested, so release the lock while locking peers one by one.
+    uint32_t index = stealingIndex_;
+    lock.unlock();
+    auto event = group->Steal(index);
+    lock.lock();
+    if (event) {
+        isIdle_ = false;
+        currentRunningEvent_ = CurrentRunningEvent(InnerEvent::Clock::now(), event);
+    }
+    return event;
+}
+
+bool EventQueueBase::BusyPollLocked(const InnerEvent::TimePoint &nextWakeUpTime, UniqueLockBase &lock)
+{
+    auto deadline = std::min(nextWakeUpTime, InnerEvent::Clock::now() + busyPollTime_);
+    busyPolling_ = true;
+    busyPollWoken_.store(false, std::memory_order_relaxed);
+    lock.unlock();
+    // Producers could not run while the only core is taken by spinning, so yield to them instead.
+    bool canSpin = CanSpin();
+    bool hit = false;
+    for (uint32_t round = 1; !hit; ++round) {
+        // Events posted through ingress queue do not wake up the runner, since it has not announced waiting.
+        hit = busyPollWoken_.load(std::memory_order_acquire) || (ingressQueue_ && !ingressQueue_->Empty());
+        if (!hit && ((round & BUSY_POLL_CLOCK_CHECK_MASK) == 0) && (InnerEvent::Clock::now() >= deadline)) {
+            // Delayed event is due now, take it without sleeping.
+            hit = (deadline == nextWakeUpTime);
+            break;
+        }
+        if (canSpin) {
+            CpuRelax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    lock.lock();
+    busyPolling_ = false;
+    // Events may be inserted after polling, but before the lock is taken again.
+    hit = hit || busyPollWoken_.load(std::memory_order_relaxed) || finished_;
+    if (hit) {
+        busyPollHitCount_.fetch_add(1, std::memory_order_relaxed);
+    }
+    return hit;
+}
+
+void EventQueueBase::JoinStealingGroup(const std::shared_ptr<StealingGroup> &group, uint32_t index)
+{
+    QueueLockGuard lock(lockType_, *queueLock_);
+    stealingGroup_ = group;
+    stealingIndex_ = index;
+    // The runner may be sleeping already, let it look for events of peers.
+    NotifyOneLocked();
+}
+
+InnerEvent::Pointer EventQueueBase::StealEvent()
+{
+    QueueLockGuard lock(lockType_, *queueLock_);
+    if (finished_ || !usable_.load()) {
+        return InnerEvent::Pointer(nullptr, nullptr);
+    }
+    DrainIngressLocked();
+    auto now = InnerEvent::Clock::now();
+    if (timingWheel_) {
+        MoveExpiredTimersLocked(now);
+    }
+    auto event = PopStealableEventLocked(now);
+    if (event) {
+        eventIndex_.Erase(*event);
+        SubEventQueue &subQueue = subEventQueues_[static_cast<uint32_t>(Priority::LOW)];
+        subQueue.frontEventHandleTime = GetFrontEventHandleTimeLocked(subQueue.queue);
+    }
+    return event;
+}
+
+bool EventQueueBase::WakeUpForStealing()
+{
+    QueueLockGuard lock(lockType_, *queueLock_);
+    if (busyPolling_) {
+        // Busy polling runner is woken up without a system call, unless it has been woken up.
+        if (busyPollWoken_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        NotifyOneLocked();
+        return true;
+    }
+    // Skip the runner which is awake or has been woken up, it looks for events of peers by itself.
+    if ((sleepingCount_ == 0) || wakeupPending_) {
+        return false;
+    }
+    NotifyOneLocked();
+    return true;
+}
+
+size_t EventQueueBase::GetQueuedEventCount()
+{
+    QueueLockGuard lock(lockType_, *queueLock_);
+    DrainIngressLocked();
+    ReturnPickedEventsLocked();
+    size_t count = idleEvents_.Size() + (timingWheel_ ? timingWheel_->Size() : 0);
+    for (const auto &subQueue : subEventQueues_) {
+        count += subQueue.queue.Size();
+    }
+    return count;
+}
+
+void EventQueueBase::EnableIngressQueue()
+{
+    LockGuardBase lock(*queueLock_);
+    if (!ingressQueue_) {
+        ingressQueue_ = std::make_unique<IngressQueue>();
+    }
+}
 }  // namespace AppExecFwk
 }  // namespace OHOS
@@ -447,7 +447,8 @@ bool EventQueueFFRT::InsertEvent(InnerEvent::Pointer &event, Priority priority,
     }
 
     // taskname: handler Id | has task | inner event id | param | task name
-    std::string taskName = event->GetOwnerId() + "|" + (event->HasTask() ? "1" : "0") + "|" +
+    auto owner = event->GetOwner();
+    std::string taskName = (owner ? owner->GetHandlerId() : std::string()) + "|" + (event->HasTask() ? "1" : "0") + "|" +
         std::to_string(event->GetInnerEventId()) + "|" + std::to_string(event->GetParam()) +
         "|" + event->GetTaskName();
     HILOGD("Submit task %{public}s, %{public}d, %{public}d, %{public}d.", taskName.c_str(), priority,
@@ -15,6 +15,7 @@
 
 #include "event_runner.h"
 
+#include <algorithm>
 #include <condition_variable>
 #include <mutex>
 #include <sstream>
@@ -22,16 +23,22 @@
 #include <unordered_map>
 #include <vector>
 
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #include <sys/prctl.h>
+#include <sys/resource.h>
 #include <sys/syscall.h>
 
 #include "event_handler.h"
+#include "event_handler_errors.h"
 #include "event_queue_base.h"
 #include "event_inner_runner.h"
 #include "event_logger.h"
 #include "securec.h"
 #include "singleton.h"
+#include "thread_info.h"
 #ifdef FFRT_USAGE_ENABLE
 #include "event_queue_ffrt.h"
 #include "ffrt_inner.h"
@@ -44,8 +51,7 @@ namespace AppExecFwk {
 namespace {
 const char *g_crashEmptyDumpInfo = "Current Event Caller is empty. Nothing to dump";
 const int CRASH_BUF_MIN_LEN = 2;
-constexpr int64_t MIN_APP_UID = 20000;
-thread_local static Caller g_currentEventCaller = {};
+thread_local static Caller g_currentEventCaller {"", 0, ""};
 thread_local static std::string g_currentEventName = {};
 
 DEFINE_EH_HILOG_LABEL("EventRunner");
@@ -61,6 +67,85 @@ inline void SystemCallSetThreadName(const std::string &name)
     HILOGD("thread name is %{public}s", name.c_str());
 }
 
+// Log the error number of a failed system call, and map it to error code.
+ErrCode ThreadAttributeError(const char *attribute, int err)
+{
+    char errmsg[MAX_ERRORMSG_LEN] = {0};
+    errno = err;
+    GetLastErr(errmsg, MAX_ERRORMSG_LEN);
+    HILOGE("Failed to set %{public}s of thread, %{public}s", attribute, errmsg);
+    return (err == EPERM) ? EVENT_HANDLER_ERR_RUNNER_NO_PERMIT : EVENT_HANDLER_ERR_INVALID_PARAM;
+}
+
+inline int ToSystemSchedPolicy(ThreadSchedPolicy policy)
+{
+    switch (policy) {
+        case ThreadSchedPolicy::FIFO:
+            return SCHED_FIFO;
+        case ThreadSchedPolicy::RR:
+            return SCHED_RR;
+        case ThreadSchedPolicy::BATCH:
+            return SCHED_BATCH;
+        case ThreadSchedPolicy::IDLE:
+            return SCHED_IDLE;
+        case ThreadSchedPolicy::OTHER:
+        default:
+            return SCHED_OTHER;
+    }
+}
+
+// Invoke system calls to apply attributes except stack size to current thread, and return the first error.
+ErrCode SystemCallSetThreadAttributes(const ThreadAttributes &attributes)
+{
+    static constexpr int32_t MIN_NICE_VALUE = -20;
+    static constexpr int32_t MAX_NICE_VALUE = 19;
+    ErrCode result = ERR_OK;
+    auto record = [&result](ErrCode code) {
+        if (result == ERR_OK) {
+            result = code;
+        }
+    };
+
+    if (!attributes.cpuSet.empty()) {
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        bool valid = true;
+        for (uint32_t cpu : attributes.cpuSet) {
+            valid = valid && (cpu < CPU_SETSIZE);
+            if (valid) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+        if (!valid) {
+            record(ThreadAttributeError("cpu set", EINVAL));
+        } else if (sched_setaffinity(0, sizeof(cpuSet), &cpuSet) != 0) {
+            record(ThreadAttributeError("cpu set", errno));
+        }
+    }
+
+    if (attributes.schedPolicy != ThreadSchedPolicy::INHERIT) {
+        int policy = ToSystemSchedPolicy(attributes.schedPolicy);
+        struct sched_param param = {};
+        // Only real time policies take a priority.
+        param.sched_priority = ((policy == SCHED_FIFO) || (policy == SCHED_RR)) ? attributes.schedPriority : 0;
+        int err = pthread_setschedparam(pthread_self(), policy, &param);
+        if (err != 0) {
+            record(ThreadAttributeError("scheduling policy", err));
+        }
+    }
+
+    if (attributes.niceValue != THREAD_NICE_INHERIT) {
+        if ((attributes.niceValue < MIN_NICE_VALUE) || (attributes.niceValue > MAX_NICE_VALUE)) {
+            record(ThreadAttributeError("nice value", EINVAL));
+        } else if (setpriority(PRIO_PROCESS, static_cast<id_t>(ThreadInfo::GetKernelThreadId()),
+            attributes.niceValue) != 0) {
+            // Nice value is per thread on linux, if the thread id is given.
+            record(ThreadAttributeError("nice value", errno));
+        }
+    }
+    return result;
+}
+
 // Help to calculate hash code of object.
 template<typename T>
 inline size_t CalculateHashCode(const T &obj)
@@ -81,7 +166,7 @@ public:
     void ReclaimCurrentThread()
     {
         // Get id of current thread.
-        auto threadId = std::this_thread::get_id();
+        auto threadId = pthread_self();
         HILOGD("Thread id: %{public}zu", CalculateHashCode(threadId));
 
         {
@@ -115,7 +200,32 @@ public:
             return false;
         }
 
-        auto threadId = thread->get_id();
+        return DoDeposit(thread->native_handle(), thread, threadExit);
+    }
+
+    // Deposit a thread created by 'pthread_create', which is joined by 'pthread_join'.
+    bool Deposit(pthread_t thread, const ExitFunction &threadExit)
+    {
+        if (!threadExit) {
+            HILOGE("null: Invalid parameter");
+            return false;
+        }
+
+        std::unique_ptr<std::thread> nullThread;
+        return DoDeposit(thread, nullThread, threadExit);
+    }
+
+private:
+    DEFINE_EH_HILOG_LABEL("ThreadCollector");
+
+    struct ThreadExitInfo {
+        // Null for thread created by 'pthread_create'.
+        std::unique_ptr<std::thread> thread;
+        ExitFunction threadExit;
+    };
+
+    bool DoDeposit(pthread_t threadId, std::unique_ptr<std::thread> &thread, const ExitFunction &threadExit)
+    {
         HILOGD("New thread id: %{public}zu", CalculateHashCode(threadId));
         // Save these information into map.
         std::lock_guard<std::mutex> lock(collectorLock_);
@@ -132,14 +242,6 @@ public:
         return true;
     }
 
-private:
-    DEFINE_EH_HILOG_LABEL("ThreadCollector");
-
-    struct ThreadExitInfo {
-        std::unique_ptr<std::thread> thread;
-        ExitFunction threadExit;
-    };
-
     inline void ReclaimAll()
     {
         HILOGD("enter");
@@ -175,7 +277,7 @@ private:
     }
 
     void DoReclaimLocked(std::unique_lock<std::mutex> &lock,
-        std::unordered_map<std::thread::id, ThreadExitInfo>::iterator it, bool needCallExit = true)
+        std::unordered_map<pthread_t, ThreadExitInfo>::iterator it, bool needCallExit = true)
     {
         if (it == depositMap_.end()) {
             return;
@@ -196,7 +298,11 @@ private:
             exitInfo.threadExit();
         }
         // Wait until thread finished.
-        exitInfo.thread->join();
+        if (exitInfo.thread) {
+            exitInfo.thread->join();
+        } else {
+            (void)pthread_join(threadId, nullptr);
+        }
         HILOGD("Done, thread id: %{public}zu", hashThreadId);
 
         // Lock again.
@@ -233,8 +339,9 @@ private:
     std::condition_variable condition_;
     bool isWaiting_ {false};
     bool destroying_ {false};
-    std::vector<std::thread::id> reclaims_;
-    std::unordered_map<std::thread::id, ThreadExitInfo> depositMap_;
+    // Threads are identified by native handle, since some of them are not created by 'std::thread'.
+    std::vector<pthread_t> reclaims_;
+    std::unordered_map<pthread_t, ThreadExitInfo> depositMap_;
 
     std::mutex threadLock_;
     // Thread for collector
@@ -299,6 +406,35 @@ public:
         queue_ = std::make_shared<EventQueueBase>(lockType);
     }
 
+    EventRunnerImpl(const std::shared_ptr<EventRunner> &runner, const EventRunnerOptions &options)
+        : EventRunnerImpl(runner, options.lockType)
+    {
+        if (options.useTimingWheel) {
+            std::static_pointer_cast<EventQueueBase>(queue_)->EnableTimingWheel();
+        }
+        if ((options.threadMode == ThreadMode::POOL) && (options.mode == Mode::DEFAULT)) {
+            pooled_ = true;
+            std::static_pointer_cast<EventQueueBase>(queue_)->EnableWorkerPool();
+        } else if (options.useIngressQueue) {
+            // Ingress queue is taken by a single consumer, so it is not used by pool.
+            std::static_pointer_cast<EventQueueBase>(queue_)->EnableIngressQueue();
+        }
+        if (options.useHighResolutionWait) {
+            std::static_pointer_cast<EventQueueBase>(queue_)->EnableHighResolutionWait();
+        }
+        if (options.maxEpollEventsPerWait > 0) {
+            std::static_pointer_cast<EventQueueBase>(queue_)->SetMaxEventsPerWait(options.maxEpollEventsPerWait);
+        }
+        if ((options.busyPollMicroseconds > 0) && !pooled_) {
+            std::static_pointer_cast<EventQueueBase>(queue_)->SetBusyPollTime(
+                std::chrono::microseconds(options.busyPollMicroseconds));
+        }
+        if ((options.pickBatchSize > 1) && !pooled_) {
+            std::static_pointer_cast<EventQueueBase>(queue_)->SetPickBatchSize(options.pickBatchSize);
+        }
+        threadAttributes_ = options.threadAttributes;
+    }
+
     ~EventRunnerImpl() final
     {
         HILOGD("enter");
@@ -318,6 +454,7 @@ public:
 
             // Call system call to modify thread name.
             SystemCallSetThreadName(inner->threadName_);
+            inner->ApplyThreadAttributes();
 
             // Enter event loop.
             inner->Run();
@@ -334,8 +471,10 @@ public:
     void Run() final
     {
         HILOGD("enter");
-        // Prepare to start event loop.
-        queue_->Prepare();
+        // Prepare to start event loop, workers of pool are started after the queue is prepared.
+        if (!pooled_) {
+            queue_->Prepare();
+        }
 
         // Make sure instance of 'EventRunner' exists.
         if (owner_.expired()) {
@@ -345,8 +484,11 @@ public:
         if (owner_.lock() == EventRunner::GetMainEventRunner()) {
             mainRunnerFlag_ = true;
         }
-        threadId_ = std::this_thread::get_id();
-        kernelThreadId_ = getproctid();
+        // Thread of pool is identified by the first worker.
+        if (!pooled_ || !workerStarted_.exchange(true)) {
+            threadId_ = std::this_thread::get_id();
+            kernelThreadId_ = ThreadInfo::GetKernelThreadId();
+        }
 
         // Save old event runner.
         std::weak_ptr<EventRunner> oldRunner = currentEventRunner;
@@ -356,6 +498,8 @@ public:
         // Start event looper.
         if (runningMode_ == Mode::NO_WAIT) {
             NoWaitModeLoop();
+        } else if (pooled_) {
+            PoolModeLoop();
         } else {
             DefaultModeLoop();
         }
@@ -406,6 +550,17 @@ public:
         }
     }
 
+    inline void PoolModeLoop()
+    {
+        auto queue = std::static_pointer_cast<EventQueueBase>(queue_);
+        for (auto event = queue->GetEvent(); event; event = queue->GetEvent()) {
+            uint64_t ownerId = event->GetOwnerNumericId();
+            ExecuteEventHandler(event);
+            // Other workers could take events of the handler from now on.
+            queue->FinishDistribution(ownerId);
+        }
+    }
+
     void RecordDispatchEventId(InnerEvent::Pointer &event)
     {
         std::shared_ptr<Logger> logging = logger_;
@@ -445,13 +600,93 @@ public:
         event.reset();
     }
 
-    inline bool Attach(std::unique_ptr<std::thread> &thread)
+    template<typename T>
+    inline bool Attach(T &thread)
     {
         auto exitThread = [queue = queue_]() { queue->Finish(); };
 
         return ThreadCollector::GetInstance().Deposit(thread, exitThread);
     }
 
+    static void StartWorkers(const std::shared_ptr<EventRunnerImpl> &inner, uint32_t count)
+    {
+        // Prepared only once, otherwise a worker started late may restart the queue which has been finished.
+        inner->queue_->Prepare();
+        for (uint32_t i = 0; i < count; ++i) {
+            if (!StartThread(inner)) {
+                HILOGW("Failed to attach worker thread, maybe process is exiting");
+                break;
+            }
+        }
+        inner->WaitThreadAttributes();
+    }
+
+    // Start a thread running 'ThreadMain' with the stack size of thread attributes, and attach it to the runner.
+    // If failed to attach, the runner is stopped and the thread is joined.
+    static bool StartThread(const std::shared_ptr<EventRunnerImpl> &inner)
+    {
+        if (inner->HasThreadAttributes()) {
+            std::lock_guard<std::mutex> lock(inner->attributesLock_);
+            ++inner->pendingAttributesCount_;
+        }
+        if (inner->threadAttributes_.stackSize != 0) {
+            pthread_t thread;
+            int err = StartNativeThread(inner, thread);
+            if (err == 0) {
+                if (inner->Attach(thread)) {
+                    return true;
+                }
+                inner->Stop();
+                (void)pthread_join(thread, nullptr);
+                return false;
+            }
+            // Thread is started with the default stack size, which reports the error before applying attributes.
+            inner->RecordThreadAttributesError(ThreadAttributeError("stack size", err));
+        }
+
+        auto thread = std::make_unique<std::thread>(EventRunnerImpl::ThreadMain, std::weak_ptr<EventRunnerImpl>(inner));
+        if (inner->Attach(thread)) {
+            return true;
+        }
+        inner->Stop();
+        thread->join();
+        return false;
+    }
+
+    // 'std::thread' takes no attributes, so thread with stack size is created by 'pthread_create'.
+    static int StartNativeThread(const std::shared_ptr<EventRunnerImpl> &inner, pthread_t &thread)
+    {
+        pthread_attr_t attr;
+        int err = pthread_attr_init(&attr);
+        if (err != 0) {
+            return err;
+        }
+        err = pthread_attr_setstacksize(&attr, inner->threadAttributes_.stackSize);
+        if (err == 0) {
+            auto wp = new (std::nothrow) std::weak_ptr<EventRunnerImpl>(inner);
+            err = (wp == nullptr) ? ENOMEM : pthread_create(&thread, &attr, NativeThreadMain, wp);
+            if (err != 0) {
+                delete wp;
+            }
+        }
+        (void)pthread_attr_destroy(&attr);
+        return err;
+    }
+
+    static void *NativeThreadMain(void *arg)
+    {
+        std::unique_ptr<std::weak_ptr<EventRunnerImpl>> wp(static_cast<std::weak_ptr<EventRunnerImpl> *>(arg));
+        ThreadMain(*wp);
+        return nullptr;
+    }
+
+    // Wait until threads started by now apply their attributes, so that the result is known after creation.
+    void WaitThreadAttributes()
+    {
+        std::unique_lock<std::mutex> lock(attributesLock_);
+        attributesCondition_.wait(lock, [this]() { return pendingAttributesCount_ == 0; });
+    }
+
     inline void SetThreadName(const std::string &threadName)
     {
         static std::atomic<uint32_t> idGenerator(1);
@@ -473,6 +708,42 @@ public:
 private:
     DEFINE_EH_HILOG_LABEL("EventRunnerImpl");
 
+    // Whether several workers take events from the queue, and whether any of them is started.
+    bool pooled_ {false};
+    std::atomic<bool> workerStarted_ {false};
+
+    // Attributes applied by each thread of runner, and count of threads which have not applied them yet.
+    ThreadAttributes threadAttributes_;
+    std::mutex attributesLock_;
+    std::condition_variable attributesCondition_;
+    uint32_t pendingAttributesCount_ {0};
+
+    inline bool HasThreadAttributes() const
+    {
+        return !threadAttributes_.cpuSet.empty() || (threadAttributes_.schedPolicy != ThreadSchedPolicy::INHERIT) ||
+            (threadAttributes_.niceValue != THREAD_NICE_INHERIT) || (threadAttributes_.stackSize != 0);
+    }
+
+    inline void RecordThreadAttributesError(ErrCode code)
+    {
+        ErrCode expected = ERR_OK;
+        (void)threadAttributesResult_.compare_exchange_strong(expected, code);
+    }
+
+    void ApplyThreadAttributes()
+    {
+        if (!HasThreadAttributes()) {
+            return;
+        }
+        ErrCode result = SystemCallSetThreadAttributes(threadAttributes_);
+        if (result != ERR_OK) {
+            RecordThreadAttributesError(result);
+        }
+        std::lock_guard<std::mutex> lock(attributesLock_);
+        --pendingAttributesCount_;
+        attributesCondition_.notify_all();
+    }
+
     static void CrashCallback(char *buf, size_t len, void *ucontext);
 
     void SetCurrentEventInfo(const InnerEvent::Pointer &event)
@@ -492,7 +763,7 @@ private:
 
     inline void ClearCurrentEventInfo()
     {
-        g_currentEventCaller = {};
+        g_currentEventCaller.ClearCaller();
         g_currentEventName.clear();
     }
 };
@@ -509,8 +780,8 @@ void EventRunnerImpl::CrashCallback(char *buf, size_t len, void *ucontext)
     }
 
     if (!g_currentEventName.empty()) {
-        const char* file = g_currentEventCaller.file_.c_str();
-        const char* func = g_currentEventCaller.func_.c_str();
+        const char* file = g_currentEventCaller.file_;
+        const char* func = g_currentEventCaller.func_;
         const char* eventName = g_currentEventName.c_str();
         int line = g_currentEventCaller.line_;
         if (snprintf_s(buf, len, len - 1, "Current Event Caller info: [%s(%s:%d)]. EventName is '%s'",
@@ -606,10 +877,25 @@ std::shared_ptr<EventRunner> EventRunner::Create(bool inNewThread, ThreadMode th
 std::shared_ptr<EventRunner> EventRunner::Create(const std::string &threadName, Mode mode,
     ThreadMode threadMode, EventLockType lockType)
 {
-    HILOGD("threadName is %{public}s %{public}d %{public}d %{public}d", threadName.c_str(), mode, threadMode, lockType);
+    EventRunnerOptions options;
+    options.mode = mode;
+    options.threadMode = threadMode;
+    options.lockType = lockType;
+    return Create(threadName, options);
+}
+
+std::shared_ptr<EventRunner> EventRunner::Create(const std::string &threadName, const EventRunnerOptions &options)
+{
+    Mode mode = options.mode;
+    ThreadMode threadMode = options.threadMode;
+    HILOGD("threadName is %{public}s %{public}d %{public}d %{public}d %{public}d %{public}d %{public}d %{public}u "
+        "%{public}u %{public}u %{public}u", threadName.c_str(), mode, threadMode, options.lockType,
+        options.useTimingWheel, options.useIngressQueue, options.useHighResolutionWait, options.maxEpollEventsPerWait,
+        options.poolSize, options.busyPollMicroseconds, options.pickBatchSize);
+    bool pooled = (threadMode == ThreadMode::POOL) && (mode == Mode::DEFAULT);
     // Constructor of 'EventRunner' is private, could not use 'std::make_shared' to construct it.
     std::shared_ptr<EventRunner> sp(new EventRunner(true, mode));
-    auto innerRunner = std::make_shared<EventRunnerImpl>(sp, lockType);
+    auto innerRunner = std::make_shared<EventRunnerImpl>(sp, options);
     innerRunner->SetRunningMode(mode);
     sp->innerRunner_ = innerRunner;
     innerRunner->SetThreadName(threadName);
@@ -620,7 +906,7 @@ std::shared_ptr<EventRunner> EventRunner::Create(const std::string &threadName,
         sp->queue_ = std::make_shared<EventQueueFFRT>();
         sp->queue_->SetIoWaiter(true);
     } else {
-        sp->threadMode_ = ThreadMode::NEW_THREAD;
+        sp->threadMode_ = pooled ? ThreadMode::POOL : ThreadMode::NEW_THREAD;
         sp->queue_ = innerRunner->GetEventQueue();
         sp->queue_->SetIoWaiter(false);
     }
@@ -628,7 +914,7 @@ std::shared_ptr<EventRunner> EventRunner::Create(const std::string &threadName,
         return sp;
     }
 #else
-    sp->threadMode_ = ThreadMode::NEW_THREAD;
+    sp->threadMode_ = pooled ? ThreadMode::POOL : ThreadMode::NEW_THREAD;
     sp->queue_ = innerRunner->GetEventQueue();
     sp->queue_->SetIoWaiter(false);
     if (mode == Mode::NO_WAIT) {
@@ -636,14 +922,20 @@ std::shared_ptr<EventRunner> EventRunner::Create(const std::string &threadName,
     }
 #endif
 
+    if (pooled) {
+        uint32_t poolSize = options.poolSize;
+        if (poolSize == 0) {
+            poolSize = std::max(std::thread::hardware_concurrency(), 1u);
+        }
+        EventRunnerImpl::StartWorkers(innerRunner, poolSize);
+        return sp;
+    }
+
     // Start new thread
-    auto thread =
-        std::make_unique<std::thread>(EventRunnerImpl::ThreadMain, std::weak_ptr<EventRunnerImpl>(innerRunner));
-    if (!innerRunner->Attach(thread)) {
+    if (!EventRunnerImpl::StartThread(innerRunner)) {
         HILOGW("Failed to attach thread, maybe process is exiting");
-        innerRunner->Stop();
-        thread->join();
     }
+    innerRunner->WaitThreadAttributes();
 
     return sp;
 }
@@ -696,13 +988,10 @@ EventRunner::~EventRunner()
 void EventRunner::StartRunningForNoWait()
 {
     auto innerRunner = std::static_pointer_cast<EventRunnerImpl>(innerRunner_);
-    auto thread =
-        std::make_unique<std::thread>(EventRunnerImpl::ThreadMain, std::weak_ptr<EventRunnerImpl>(innerRunner));
-    if (!innerRunner->Attach(thread)) {
+    if (!EventRunnerImpl::StartThread(innerRunner)) {
         HILOGW("Failed to attach thread for no wait, maybe process is exiting");
-        innerRunner->Stop();
-        thread->join();
     }
+    innerRunner->WaitThreadAttributes();
 }
 
 ErrCode EventRunner::Run()
@@ -749,6 +1038,23 @@ ErrCode EventRunner::Stop()
     return ERR_OK;
 }
 
+ErrCode EventRunner::GetThreadAttributesResult() const
+{
+    return innerRunner_ ? innerRunner_->GetThreadAttributesResult() : ERR_OK;
+}
+
+EventRunnerStats EventRunner::GetStats() const
+{
+    EventRunnerStats stats;
+    // Queue of FFRT mode neither sleeps nor busy polls by itself.
+    if (queue_ && (threadMode_ != ThreadMode::FFRT)) {
+        auto queue = std::static_pointer_cast<EventQueueBase>(queue_);
+        queue->GetWakeupCounts(stats.issuedWakeupCount, stats.elidedWakeupCount);
+        queue->GetBusyPollCounts(stats.busyPollHitCount, stats.busyPollParkCount);
+    }
+    return stats;
+}
+
 void EventRunner::Dump(Dumper &dumper)
 {
     if (!IsRunning()) {
@@ -831,6 +1137,10 @@ uint64_t EventRunner::GetKernelThreadId()
 
 bool EventRunner::IsCurrentRunnerThread()
 {
+    if (threadMode_ == ThreadMode::POOL) {
+        // Any worker of pool is a thread of this runner.
+        return EventInnerRunner::GetCurrentEventRunner().get() == this;
+    }
 #ifdef FFRT_USAGE_ENABLE
     if (ffrt_this_task_get_id()) {
         auto handler = ffrt_get_current_queue_eventhandler();
@@ -865,19 +1175,7 @@ std::shared_ptr<EventRunner> EventRunner::GetMainEventRunner()
 
 bool EventRunner::IsAppMainThread()
 {
-    static int pid = -1;
-    static int uid = -1;
-
-    if (pid == -1) {
-        pid = getpid();
-    }
-    if (uid == -1) {
-        uid = getuid();
-    }
-    if (pid == gettid() && uid >= MIN_APP_UID) {
-        return true;
-    }
-    return false;
+    return ThreadInfo::IsAppMainThread();
 }
 
 void EventRunner::SetMainLooperWatcher(const DistributeBeginTime begin,
@@ -0,0 +1,93 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "event_runner_group.h"
+
+#include "event_logger.h"
+#include "event_queue_base.h"
+#include "stealing_group.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+namespace {
+DEFINE_EH_HILOG_LABEL("EventRunnerGroup");
+}  // unnamed namespace
+
+EventRunnerGroup::~EventRunnerGroup()
+{
+    HILOGD("enter");
+}
+
+std::shared_ptr<EventRunnerGroup> EventRunnerGroup::Create(const std::string &name, uint32_t count,
+    const EventRunnerOptions &options)
+{
+    if (count == 0) {
+        HILOGE("Could not create an empty group");
+        return nullptr;
+    }
+    if ((options.threadMode != ThreadMode::NEW_THREAD) || (options.mode != Mode::DEFAULT)) {
+        HILOGE("Only runners with thread mode NEW_THREAD and mode DEFAULT could be grouped");
+        return nullptr;
+    }
+
+    // Constructor of 'EventRunnerGroup' is private, could not use 'std::make_shared' to construct it.
+    std::shared_ptr<EventRunnerGroup> group(new EventRunnerGroup());
+    std::vector<std::shared_ptr<EventQueueBase>> queues;
+    queues.reserve(count);
+    group->runners_.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto runner = EventRunner::Create(name + "#" + std::to_string(i), options);
+        if ((runner == nullptr) || (runner->GetEventQueue() == nullptr)) {
+            HILOGE("Failed to create runner %{public}u of group", i);
+            return nullptr;
+        }
+        queues.emplace_back(std::static_pointer_cast<EventQueueBase>(runner->GetEventQueue()));
+        group->runners_.emplace_back(std::move(runner));
+    }
+
+    group->stealingGroup_ = std::make_shared<StealingGroup>(queues);
+    for (uint32_t i = 0; i < count; ++i) {
+        queues[i]->JoinStealingGroup(group->stealingGroup_, i);
+    }
+    return group;
+}
+
+std::shared_ptr<EventRunner> EventRunnerGroup::GetRunner(uint32_t index) const
+{
+    if (index >= runners_.size()) {
+        HILOGE("Index %{public}u is out of range", index);
+        return nullptr;
+    }
+    return runners_[index];
+}
+
+std::shared_ptr<EventRunner> EventRunnerGroup::GetRunnerByKey(uint64_t key) const
+{
+    return runners_[key % runners_.size()];
+}
+
+std::vector<EventRunnerGroupStats> EventRunnerGroup::GetStats() const
+{
+    std::vector<EventRunnerGroupStats> stats(runners_.size());
+    for (uint32_t i = 0; i < runners_.size(); ++i) {
+        stats[i].stolenCount = stealingGroup_->GetStolenCount(i);
+        stats[i].lostCount = stealingGroup_->GetLostCount(i);
+        auto queue = std::static_pointer_cast<EventQueueBase>(runners_[i]->GetEventQueue());
+        stats[i].queueDepth = queue->GetQueuedEventCount();
+    }
+    return stats;
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
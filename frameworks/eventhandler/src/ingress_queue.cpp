@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "ingress_queue.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+IngressQueue::~IngressQueue()
+{
+    // Drop events which are never taken.
+    std::vector<InnerEvent::Pointer> events;
+    PopAll(events);
+}
+
+bool IngressQueue::PushChain(InnerEvent *first, InnerEvent *last)
+{
+    // Stack is linked from the last pushed event, so the first event of chain is linked to the current top.
+    InnerEvent *top = head_.load(std::memory_order_relaxed);
+    do {
+        first->ingressNext_ = top;
+    } while (!head_.compare_exchange_weak(top, last, std::memory_order_seq_cst, std::memory_order_relaxed));
+    return CheckWaiting();
+}
+
+bool IngressQueue::CheckWaiting()
+{
+    // Pairs with 'PrepareWait': either the producer sees the announcement, or the consumer sees the event.
+    // Only one producer takes the announcement, so the consumer is notified once.
+    return waiting_.load(std::memory_order_seq_cst) && waiting_.exchange(false, std::memory_order_seq_cst);
+}
+
+bool IngressQueue::Push(InnerEvent::Pointer &event)
+{
+    InnerEvent *raw = event.release();
+    return PushChain(raw, raw);
+}
+
+bool IngressQueue::PushBatch(std::vector<InnerEvent::Pointer> &events)
+{
+    if (events.empty()) {
+        return false;
+    }
+    // Link events in reversed order, the same as pushing them one by one.
+    InnerEvent *first = events.front().release();
+    InnerEvent *last = first;
+    for (size_t i = 1; i < events.size(); ++i) {
+        InnerEvent *event = events[i].release();
+        event->ingressNext_ = last;
+        last = event;
+    }
+    return PushChain(first, last);
+}
+
+void IngressQueue::PopAll(std::vector<InnerEvent::Pointer> &events)
+{
+    InnerEvent *top = head_.exchange(nullptr, std::memory_order_acquire);
+    if (top == nullptr) {
+        return;
+    }
+
+    // Reverse the stack into order of pushing.
+    InnerEvent *first = nullptr;
+    size_t count = 0;
+    while (top != nullptr) {
+        InnerEvent *next = top->ingressNext_;
+        top->ingressNext_ = first;
+        first = top;
+        top = next;
+        ++count;
+    }
+    events.reserve(events.size() + count);
+    while (first != nullptr) {
+        InnerEvent *next = first->ingressNext_;
+        first->ingressNext_ = nullptr;
+        events.emplace_back(InnerEvent::Adopt(first));
+        first = next;
+    }
+}
+
+bool IngressQueue::PrepareWait()
+{
+    waiting_.store(true, std::memory_order_seq_cst);
+    if (head_.load(std::memory_order_seq_cst) != nullptr) {
+        FinishWait();
+        return false;
+    }
+    return true;
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
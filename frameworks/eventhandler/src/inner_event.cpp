@@ -15,11 +15,15 @@
 
 #include "inner_event.h"
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstdlib>
 #include <mutex>
+#include <unordered_set>
 #include <vector>
 
+#include "event_handler.h"
 #include "event_handler_utils.h"
 #include "event_logger.h"
 #include "singleton.h"
@@ -31,6 +35,7 @@ namespace {
 static constexpr int DATETIME_STRING_LENGTH = 80;
 static constexpr int MAX_MS_LENGTH = 3;
 static constexpr int MS_PER_SECOND = 1000;
+static constexpr int DECIMAL_BASE = 10;
 DEFINE_EH_HILOG_LABEL("InnerEvent");
 
 class WaiterImp final : public InnerEvent::Waiter {
@@ -64,8 +69,47 @@ private:
     uint32_t waitingCount_ {0};
     bool finished_ {false};
 };
+
+// Keep a copy of the string until the process exits, and return the same pointer for the same string.
+const char *InternCallerString(const std::string &str)
+{
+    if (str.empty()) {
+        return "";
+    }
+    static std::mutex internLock;
+    // Never destroyed, since caller info may be used while the process is exiting.
+    static auto *internedStrings = new std::unordered_set<std::string>();
+    std::lock_guard<std::mutex> lock(internLock);
+    return internedStrings->emplace(str).first->c_str();
+}
 }  // unnamed namespace
 
+Caller::Caller(const std::string &file, int line, const std::string &func)
+    : file_(InternCallerString(file)), line_(line), func_(InternCallerString(func))
+{}
+
+void Caller::SetDfxName(const std::string &dfxName)
+{
+    dfxName_ = InternCallerString(dfxName);
+}
+
+std::string Caller::ToString() const
+{
+    if ((file_ == nullptr) || (file_[0] == '\0')) {
+        return std::string("[ ]");
+    }
+    const char *fileName = file_;
+    for (const char *p = file_; *p != '\0'; ++p) {
+        if ((*p == '/') || (*p == '\\')) {
+            fileName = p + 1;
+        }
+    }
+    std::string caller("[");
+    caller.append(fileName).append("(").append((func_ == nullptr) ? "" : func_).append(":");
+    caller.append(std::to_string(line_)).append((dfxName_ == nullptr) ? "" : dfxName_).append(")]");
+    return caller;
+}
+
 // Implementation for event pool.
 class InnerEventPool : public DelayedRefSingleton<InnerEventPool> {
     DECLARE_DELAYED_REF_SINGLETON(InnerEventPool);
@@ -75,33 +119,187 @@ public:
 
     InnerEvent::Pointer Get()
     {
+        InnerEvent *event = PopLocal();
+        if (event == nullptr) {
+            event = RefillLocal();
+        }
+        if (event != nullptr) {
+            hitCount_.fetch_add(1, std::memory_order_relaxed);
+            return InnerEvent::Pointer(event, Drop);
+        }
+
         // Allocate new memory, while pool is empty.
+        missCount_.fetch_add(1, std::memory_order_relaxed);
         return InnerEvent::Pointer(new (std::nothrow) InnerEvent, Drop);
     }
 
+    static InnerEvent::Pointer Adopt(InnerEvent *event)
+    {
+        return InnerEvent::Pointer(event, Drop);
+    }
+
+    InnerEventPoolStats GetStats() const
+    {
+        InnerEventPoolStats stats;
+        stats.hitCount = hitCount_.load(std::memory_order_relaxed);
+        stats.missCount = missCount_.load(std::memory_order_relaxed);
+        stats.pooledCount = pooledCount_.load(std::memory_order_relaxed);
+        stats.highWaterCount = highWaterCount_.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    // Called while a thread exits, hand over its cached events to the global list.
+    void ReleaseLocalCache();
+
 private:
+    static constexpr size_t LOCAL_CACHE_CAPACITY = 32;
+    static constexpr size_t LOCAL_REFILL_COUNT = LOCAL_CACHE_CAPACITY / 2;
+    static constexpr size_t GLOBAL_POOL_CAPACITY = 1024;
+
+    // Trivially destructible, so it stays accessible while other thread local objects are destroyed.
+    struct LocalCache {
+        InnerEvent *events[LOCAL_CACHE_CAPACITY];
+        size_t count;
+        bool released;
+    };
+
+    struct LocalCacheReleaser {
+        ~LocalCacheReleaser()
+        {
+            InnerEventPool::GetInstance().ReleaseLocalCache();
+        }
+    };
+
+    static LocalCache &GetLocalCache()
+    {
+        static thread_local LocalCache localCache = {};
+        return localCache;
+    }
+
     static void Drop(InnerEvent *event)
     {
         if (event == nullptr) {
             return;
         }
 
-        // Clear content of the event
+        // Clear content of the event, and give it back to pool.
         event->ClearEvent();
-        if (event != nullptr) {
-            delete event;
+        InnerEventPool::GetInstance().Recycle(event);
+    }
+
+    InnerEvent *PopLocal()
+    {
+        LocalCache &cache = GetLocalCache();
+        if (cache.count == 0) {
+            return nullptr;
         }
+        pooledCount_.fetch_sub(1, std::memory_order_relaxed);
+        return cache.events[--cache.count];
     }
+
+    InnerEvent *RefillLocal();
+    void Recycle(InnerEvent *event);
+    bool PushGlobal(InnerEvent *event);
+    void UpdateHighWater(size_t pooledCount);
+
+    std::mutex globalLock_;
+    std::vector<InnerEvent *> globalEvents_;
+    std::atomic<uint64_t> hitCount_ {0};
+    std::atomic<uint64_t> missCount_ {0};
+    std::atomic<size_t> pooledCount_ {0};
+    std::atomic<size_t> highWaterCount_ {0};
 };
 
 InnerEventPool::InnerEventPool()
 {
     HILOGD("InnerEventPool enter");
+    globalEvents_.reserve(GLOBAL_POOL_CAPACITY);
 }
 
 InnerEventPool::~InnerEventPool()
 {
     HILOGD("~InnerEventPool enter");
+    std::lock_guard<std::mutex> lock(globalLock_);
+    for (auto event : globalEvents_) {
+        delete event;
+    }
+    globalEvents_.clear();
+}
+
+InnerEvent *InnerEventPool::RefillLocal()
+{
+    LocalCache &cache = GetLocalCache();
+    std::lock_guard<std::mutex> lock(globalLock_);
+    if (globalEvents_.empty()) {
+        return nullptr;
+    }
+
+    InnerEvent *event = globalEvents_.back();
+    globalEvents_.pop_back();
+    pooledCount_.fetch_sub(1, std::memory_order_relaxed);
+
+    // Move a batch into local cache, so that following requests do not touch the global lock.
+    if (!cache.released) {
+        while ((cache.count < LOCAL_REFILL_COUNT) && !globalEvents_.empty()) {
+            cache.events[cache.count++] = globalEvents_.back();
+            globalEvents_.pop_back();
+        }
+    }
+    return event;
+}
+
+void InnerEventPool::Recycle(InnerEvent *event)
+{
+    LocalCache &cache = GetLocalCache();
+    if (!cache.released && (cache.count < LOCAL_CACHE_CAPACITY)) {
+        // Make sure the cached events will be handed over while this thread exits.
+        static thread_local LocalCacheReleaser releaser;
+        (void)releaser;
+        cache.events[cache.count++] = event;
+        UpdateHighWater(pooledCount_.fetch_add(1, std::memory_order_relaxed) + 1);
+        return;
+    }
+
+    if (!PushGlobal(event)) {
+        delete event;
+    }
+}
+
+bool InnerEventPool::PushGlobal(InnerEvent *event)
+{
+    std::lock_guard<std::mutex> lock(globalLock_);
+    if (globalEvents_.size() >= GLOBAL_POOL_CAPACITY) {
+        return false;
+    }
+    globalEvents_.push_back(event);
+    UpdateHighWater(pooledCount_.fetch_add(1, std::memory_order_relaxed) + 1);
+    return true;
+}
+
+void InnerEventPool::UpdateHighWater(size_t pooledCount)
+{
+    size_t highWater = highWaterCount_.load(std::memory_order_relaxed);
+    while ((pooledCount > highWater) &&
+        !highWaterCount_.compare_exchange_weak(highWater, pooledCount, std::memory_order_relaxed)) {
+    }
+}
+
+void InnerEventPool::ReleaseLocalCache()
+{
+    LocalCache &cache = GetLocalCache();
+    cache.released = true;
+    while (cache.count > 0) {
+        InnerEvent *event = cache.events[--cache.count];
+        pooledCount_.fetch_sub(1, std::memory_order_relaxed);
+        if (!PushGlobal(event)) {
+            delete event;
+        }
+    }
+}
+
+InnerEventPoolStats InnerEvent::GetPoolStats()
+{
+    return InnerEventPool::GetInstance().GetStats();
 }
 
 InnerEvent::Pointer InnerEvent::Get()
@@ -110,6 +308,11 @@ InnerEvent::Pointer InnerEvent::Get()
     return event;
 }
 
+InnerEvent::Pointer InnerEvent::Adopt(InnerEvent *event)
+{
+    return InnerEventPool::Adopt(event);
+}
+
 InnerEvent::Pointer InnerEvent::Get(uint32_t innerEventId, int64_t param, const Caller &caller)
 {
     auto event = InnerEventPool::GetInstance().Get();
@@ -152,7 +355,25 @@ InnerEvent::Pointer InnerEvent::Get(const Callback &callback, const std::string
 
     auto event = InnerEventPool::GetInstance().Get();
     if (event != nullptr) {
-        event->taskCallback_ = callback;
+        event->task_ = TaskCallable(callback);
+        event->taskName_ = name;
+        event->caller_ = caller;
+        HILOGD("event taskName is '%{public}s', caller is %{public}s", name.c_str(), caller.ToString().c_str());
+    }
+    return event;
+}
+
+InnerEvent::Pointer InnerEvent::Get(TaskCallable &&task, const std::string &name, const Caller &caller)
+{
+    // Returns nullptr while task is empty.
+    if (!task) {
+        HILOGW("Failed to create inner event with an empty task");
+        return InnerEvent::Pointer(nullptr, nullptr);
+    }
+
+    auto event = InnerEventPool::GetInstance().Get();
+    if (event != nullptr) {
+        event->task_ = std::move(task);
         event->taskName_ = name;
         event->caller_ = caller;
         HILOGD("event taskName is '%{public}s', caller is %{public}s", name.c_str(), caller.ToString().c_str());
@@ -160,6 +381,12 @@ InnerEvent::Pointer InnerEvent::Get(const Callback &callback, const std::string
     return event;
 }
 
+const InnerEvent::Callback &InnerEvent::GetTaskCallback() const
+{
+    // Tasks posted as other callables are converted at the first call, and run by 'RunTask' as well.
+    return task_.ToCallback();
+}
+
 void InnerEvent::ClearEvent()
 {
     // Wake up all waiting threads.
@@ -168,27 +395,48 @@ void InnerEvent::ClearEvent()
         waiter_.reset();
     }
 
-    if (HasTask()) {
-        // Clear members for task
-        taskName_.clear();
-        caller_.ClearCaller();
-    } else {
-        // Clear members for event
-        if (smartPtrDtor_) {
-            smartPtrDtor_(smartPtr_);
-            smartPtrDtor_ = nullptr;
-            smartPtr_ = nullptr;
-            smartPtrTypeId_ = 0;
-        }
-    }
+    // Clear members for task, keep capacity of strings for reusing.
+    task_ = nullptr;
+    taskName_.clear();
+    caller_.ClearCaller();
 
-    if (hiTraceId_) {
-        hiTraceId_.reset();
+    // Clear members for event
+    if (smartPtrDtor_) {
+        smartPtrDtor_(smartPtr_);
     }
+    smartPtrDtor_ = nullptr;
+    smartPtr_ = nullptr;
+    smartPtrTypeId_ = 0;
+    innerEventId_ = 0u;
+    param_ = 0;
 
     // Clear owner
     owner_.reset();
+    ownerNumericId_ = 0;
     ReleaseStackId();
+    if (diagnostics_) {
+        diagnostics_->hiTraceId.reset();
+        diagnostics_->stackId = 0;
+        diagnostics_->emitterId = 0;
+        diagnostics_->ownerId.clear();
+    }
+
+    // Reset remaining states, so that the event could be recycled by pool.
+    handleTime_ = TimePoint();
+    sendTime_ = TimePoint();
+    senderKernelThreadId_ = 0;
+    eventUniqueId_ = 0;
+    priority = -1;
+    isVsync_ = false;
+    isBarrier_ = false;
+    delayTime_ = 0;
+    isEnhanced_ = false;
+    isThreadAffine_ = false;
+    ownerLink_ = EventIndexLink();
+    keyLink_ = EventIndexLink();
+    ingressNext_ = nullptr;
+    queueLocation_ = 0;
+    isDiscarded_ = false;
 }
 
 void InnerEvent::WarnSmartPtrCastMismatch()
@@ -207,10 +455,39 @@ bool InnerEvent::HasWaiter() const
     return (waiter_ != nullptr);
 }
 
+InnerEvent::Diagnostics &InnerEvent::GetDiagnostics()
+{
+    if (!diagnostics_) {
+        diagnostics_ = std::make_unique<Diagnostics>();
+    }
+    return *diagnostics_;
+}
+
+void InnerEvent::SetOwnerId(std::string ownerId)
+{
+    ownerNumericId_ = std::strtoull(ownerId.c_str(), nullptr, DECIMAL_BASE);
+    if (!ownerId.empty() || diagnostics_) {
+        GetDiagnostics().ownerId = std::move(ownerId);
+    }
+}
+
+std::string InnerEvent::GetOwnerId()
+{
+    if (diagnostics_ && !diagnostics_->ownerId.empty()) {
+        return diagnostics_->ownerId;
+    }
+    // Events posted by handlers are tagged by numeric id only, take the string id from the owner.
+    auto owner = owner_.lock();
+    if ((ownerNumericId_ != 0) && owner && (owner->GetHandlerNumericId() == ownerNumericId_)) {
+        return owner->GetHandlerId();
+    }
+    return std::string();
+}
+
 const std::shared_ptr<HiTraceId> InnerEvent::GetOrCreateTraceId()
 {
-    if (hiTraceId_) {
-        return hiTraceId_;
+    if (diagnostics_ && diagnostics_->hiTraceId) {
+        return diagnostics_->hiTraceId;
     }
 
     auto traceId = HiTraceChain::GetId();
@@ -218,13 +495,14 @@ const std::shared_ptr<HiTraceId> InnerEvent::GetOrCreateTraceId()
         return nullptr;
     }
 
-    hiTraceId_ = std::make_shared<HiTraceId>(HiTraceChain::CreateSpan());
-    return hiTraceId_;
+    auto &hiTraceId = GetDiagnostics().hiTraceId;
+    hiTraceId = std::make_shared<HiTraceId>(HiTraceChain::CreateSpan());
+    return hiTraceId;
 }
 
 const std::shared_ptr<HiTraceId> InnerEvent::GetTraceId()
 {
-    return hiTraceId_;
+    return diagnostics_ ? diagnostics_->hiTraceId : nullptr;
 }
 
 std::string InnerEvent::DumpTimeToString(const std::chrono::system_clock::time_point &time)
@@ -309,14 +587,13 @@ std::string InnerEvent::TraceInfo()
 
 void InnerEvent::SetEventUniqueId()
 {
-    auto nowTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::steady_clock::now().time_since_epoch()).count();
-    eventId = std::to_string(nowTime);
+    static std::atomic<uint64_t> eventSequence {0};
+    eventUniqueId_ = eventSequence.fetch_add(1, std::memory_order_relaxed) + 1;
 }
 
 void InnerEvent::ReleaseStackId()
 {
-    AsyncStackAdapter::GetInstance().EventReleaseStackId(stackId_);
+    AsyncStackAdapter::GetInstance().EventReleaseStackId(GetStackId());
 }
 }  // namespace AppExecFwk
 }  // namespace OHOS
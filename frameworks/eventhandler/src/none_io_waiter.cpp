@@ -36,11 +36,14 @@ NoneIoWaiter::~NoneIoWaiter()
 
 bool NoneIoWaiter::WaitFor(UniqueLockBase &externLock, int64_t nanoseconds, bool vsyncOnly)
 {
+    // Take the generation before unlocking, a broadcast after that MUST wake up this thread.
+    std::unique_lock<std::mutex> lock(waitLock_);
+    uint64_t generation = generation_;
     externLock.unlock();
 
-    std::unique_lock<std::mutex> lock(waitLock_);
+    auto pred = [this, generation] { return this->pred_ || (this->generation_ != generation); };
     if (nanoseconds < 0) {
-        condition_.wait(lock, [this] { return this->pred_; });
+        condition_.wait(lock, pred);
     } else {
         /*
          * Fix a problem in some versions of STL.
@@ -49,11 +52,12 @@ bool NoneIoWaiter::WaitFor(UniqueLockBase &externLock, int64_t nanoseconds, bool
          */
         static const auto oneYear = std::chrono::hours(HOURS_PER_YEAR);
         auto duration = std::chrono::nanoseconds(nanoseconds);
-        (void)condition_.wait_for(lock, (duration > oneYear) ? oneYear : duration, [this] { return this->pred_; });
+        (void)condition_.wait_for(lock, (duration > oneYear) ? oneYear : duration, pred);
     }
     lock.unlock();
 
     externLock.lock();
+    lock.lock();
     pred_ = false;
     return true;
 }
@@ -69,6 +73,7 @@ void NoneIoWaiter::NotifyAll()
 {
     std::lock_guard<std::mutex> lock(waitLock_);
     pred_ = true;
+    ++generation_;
     condition_.notify_all();
 }
 
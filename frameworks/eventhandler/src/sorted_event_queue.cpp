@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "sorted_event_queue.h"
+
+#include <iterator>
+
+namespace OHOS {
+namespace AppExecFwk {
+void SortedEventQueue::Insert(InnerEvent::Pointer &event, EventInsertType insertType)
+{
+    EventIndex::SetLocation(*event, EventLocation::SORTED_QUEUE);
+    if (insertType == EventInsertType::AT_FRONT) {
+        if (!Empty()) {
+            // Ensure that events queue is in ordered
+            const auto &headEvent = Front();
+            if (headEvent->GetHandleTime() < event->GetHandleTime()) {
+                event->SetHandleTime(headEvent->GetHandleTime());
+            }
+        }
+        // Handle time is not later than any other event, and sequence is the smallest, so it is always the front.
+        auto handleTime = event->GetHandleTime();
+        fifoEvents_.emplace_front(Node {handleTime, --frontSequence_, std::move(event)});
+        return;
+    }
+
+    auto handleTime = event->GetHandleTime();
+    Node node {handleTime, ++backSequence_, std::move(event)};
+    // Events without delay are mostly sent in order of time, just append them.
+    bool withoutDelay = (handleTime <= node.event->GetSendTime());
+    if (withoutDelay && (fifoEvents_.empty() || (fifoEvents_.back().handleTime <= handleTime))) {
+        fifoEvents_.emplace_back(std::move(node));
+        return;
+    }
+
+    delayedEvents_.emplace_back(std::move(node));
+    std::push_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+}
+
+void SortedEventQueue::InsertBatch(std::vector<InnerEvent::Pointer> &events)
+{
+    size_t heapSize = delayedEvents_.size();
+    for (auto &event : events) {
+        EventIndex::SetLocation(*event, EventLocation::SORTED_QUEUE);
+        auto handleTime = event->GetHandleTime();
+        Node node {handleTime, ++backSequence_, std::move(event)};
+        bool withoutDelay = (handleTime <= node.event->GetSendTime());
+        if (withoutDelay && (fifoEvents_.empty() || (fifoEvents_.back().handleTime <= handleTime))) {
+            fifoEvents_.emplace_back(std::move(node));
+        } else {
+            delayedEvents_.emplace_back(std::move(node));
+        }
+    }
+
+    // Rebuilding the heap is linear, it is cheaper than pushing events one by one if the batch is not small.
+    size_t added = delayedEvents_.size() - heapSize;
+    if (added >= heapSize) {
+        std::make_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+        return;
+    }
+    for (size_t i = heapSize; i < delayedEvents_.size(); ++i) {
+        std::push_heap(delayedEvents_.begin(), delayedEvents_.begin() + i + 1, After);
+    }
+}
+
+const InnerEvent::Pointer &SortedEventQueue::Front() const
+{
+    return FrontIsDelayed() ? delayedEvents_.front().event : fifoEvents_.front().event;
+}
+
+InnerEvent::Pointer SortedEventQueue::PopFront()
+{
+    if (FrontIsDelayed()) {
+        std::pop_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+        InnerEvent::Pointer event = std::move(delayedEvents_.back().event);
+        delayedEvents_.pop_back();
+        PurgeFront();
+        return event;
+    }
+
+    InnerEvent::Pointer event = std::move(fifoEvents_.front().event);
+    fifoEvents_.pop_front();
+    PurgeFront();
+    return event;
+}
+
+InnerEvent::Pointer SortedEventQueue::PopFirst(const Filter &filter)
+{
+    auto nodeFilter = [&filter](const Node &node) {
+        return !EventIndex::IsDiscarded(*node.event) && filter(node.event);
+    };
+    auto fifoIt = std::find_if(fifoEvents_.begin(), fifoEvents_.end(), nodeFilter);
+
+    // Delayed events are not sorted, find the earliest one.
+    auto delayedIt = delayedEvents_.end();
+    for (auto it = delayedEvents_.begin(); it != delayedEvents_.end(); ++it) {
+        if (((delayedIt == delayedEvents_.end()) || Before(*it, *delayedIt)) && nodeFilter(*it)) {
+            delayedIt = it;
+        }
+    }
+
+    if ((delayedIt != delayedEvents_.end()) && ((fifoIt == fifoEvents_.end()) || Before(*delayedIt, *fifoIt))) {
+        InnerEvent::Pointer event = std::move(delayedIt->event);
+        delayedEvents_.erase(delayedIt);
+        std::make_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+        PurgeFront();
+        return event;
+    }
+
+    if (fifoIt != fifoEvents_.end()) {
+        InnerEvent::Pointer event = std::move(fifoIt->event);
+        fifoEvents_.erase(fifoIt);
+        PurgeFront();
+        return event;
+    }
+    return InnerEvent::Pointer(nullptr, nullptr);
+}
+
+bool SortedEventQueue::HasIf(const Filter &filter) const
+{
+    auto nodeFilter = [&filter](const Node &node) {
+        return !EventIndex::IsDiscarded(*node.event) && filter(node.event);
+    };
+    return std::any_of(fifoEvents_.begin(), fifoEvents_.end(), nodeFilter) ||
+        std::any_of(delayedEvents_.begin(), delayedEvents_.end(), nodeFilter);
+}
+
+void SortedEventQueue::RemoveIf(const Filter &filter)
+{
+    // Discarded events are dropped together.
+    auto nodeFilter = [&filter](const Node &node) {
+        return EventIndex::IsDiscarded(*node.event) || filter(node.event);
+    };
+    fifoEvents_.erase(std::remove_if(fifoEvents_.begin(), fifoEvents_.end(), nodeFilter), fifoEvents_.end());
+
+    auto it = std::remove_if(delayedEvents_.begin(), delayedEvents_.end(), nodeFilter);
+    if (it != delayedEvents_.end()) {
+        delayedEvents_.erase(it, delayedEvents_.end());
+        std::make_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+    }
+    discardedCount_ = 0;
+}
+
+void SortedEventQueue::MoveIf(const Filter &filter, std::list<InnerEvent::Pointer> &events)
+{
+    // Discarded events are dropped together, and never moved out.
+    auto moveOut = [&filter, &events](Node &node) {
+        if (EventIndex::IsDiscarded(*node.event)) {
+            node.event.reset();
+        } else if (filter(node.event)) {
+            events.emplace_back(std::move(node.event));
+        }
+    };
+    auto isEmpty = [](const Node &node) { return !node.event; };
+    std::for_each(fifoEvents_.begin(), fifoEvents_.end(), moveOut);
+    fifoEvents_.erase(std::remove_if(fifoEvents_.begin(), fifoEvents_.end(), isEmpty), fifoEvents_.end());
+
+    std::for_each(delayedEvents_.begin(), delayedEvents_.end(), moveOut);
+    auto it = std::remove_if(delayedEvents_.begin(), delayedEvents_.end(), isEmpty);
+    if (it != delayedEvents_.end()) {
+        delayedEvents_.erase(it, delayedEvents_.end());
+        std::make_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+    }
+    discardedCount_ = 0;
+}
+
+void SortedEventQueue::Clear()
+{
+    fifoEvents_.clear();
+    delayedEvents_.clear();
+    discardedCount_ = 0;
+}
+
+void SortedEventQueue::MarkDiscarded()
+{
+    ++discardedCount_;
+    PurgeFront();
+}
+
+void SortedEventQueue::PurgeFront()
+{
+    if (discardedCount_ == 0) {
+        return;
+    }
+    while (!fifoEvents_.empty() && EventIndex::IsDiscarded(*fifoEvents_.front().event)) {
+        fifoEvents_.pop_front();
+        --discardedCount_;
+    }
+    while (!delayedEvents_.empty() && EventIndex::IsDiscarded(*delayedEvents_.front().event)) {
+        std::pop_heap(delayedEvents_.begin(), delayedEvents_.end(), After);
+        delayedEvents_.pop_back();
+        --discardedCount_;
+    }
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
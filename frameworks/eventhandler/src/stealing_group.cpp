@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "stealing_group.h"
+
+#include "event_queue_base.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+StealingGroup::StealingGroup(const std::vector<std::shared_ptr<EventQueueBase>> &queues)
+    : size_(queues.size()), members_(std::make_unique<Member[]>(queues.size()))
+{
+    for (size_t i = 0; i < size_; ++i) {
+        members_[i].queue = queues[i];
+    }
+}
+
+InnerEvent::Pointer StealingGroup::Steal(uint32_t thief)
+{
+    // Start from the next peer, so that thieves do not rush to the same victim.
+    for (size_t i = 1; i < size_; ++i) {
+        size_t victim = (thief + i) % size_;
+        auto event = members_[victim].queue->StealEvent();
+        if (event) {
+            members_[thief].stolenCount.fetch_add(1, std::memory_order_relaxed);
+            members_[victim].lostCount.fetch_add(1, std::memory_order_relaxed);
+            return event;
+        }
+    }
+    return InnerEvent::Pointer(nullptr, nullptr);
+}
+
+void StealingGroup::NotifyStealable(uint32_t victim)
+{
+    // Pairs with 'EnterIdle': either the victim sees the idle runner, or the idle runner sees the events.
+    if (idleCount_.load(std::memory_order_seq_cst) == 0) {
+        return;
+    }
+    notifiedCount_.fetch_add(1, std::memory_order_seq_cst);
+    for (size_t i = 1; i < size_; ++i) {
+        if (members_[(victim + i) % size_].queue->WakeUpForStealing()) {
+            return;
+        }
+    }
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
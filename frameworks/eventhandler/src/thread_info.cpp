@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "thread_info.h"
+
+#include <mutex>
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace OHOS {
+namespace AppExecFwk {
+namespace {
+constexpr int64_t MIN_APP_UID = 20000;
+}  // unnamed namespace
+
+thread_local ThreadInfo::Info ThreadInfo::current_;
+std::atomic<uint64_t> ThreadInfo::generation_ {1};
+
+void ThreadInfo::Refresh()
+{
+    static std::once_flag atForkOnce;
+    std::call_once(atForkOnce, []() {
+        (void)pthread_atfork(nullptr, nullptr, []() { generation_.fetch_add(1, std::memory_order_relaxed); });
+    });
+
+    current_.kernelThreadId = getproctid();
+    current_.isAppMainThread = (getpid() == gettid()) && (getuid() >= MIN_APP_UID);
+    current_.generation = generation_.load(std::memory_order_relaxed);
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
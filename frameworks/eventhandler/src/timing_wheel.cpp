@@ -0,0 +1,217 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "timing_wheel.h"
+
+#include <chrono>
+
+namespace OHOS {
+namespace AppExecFwk {
+namespace {
+constexpr uint64_t MAX_TICK_IN_TIME_POINT =
+    static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        InnerEvent::TimePoint::duration::max()).count());
+}  // unnamed namespace
+
+TimingWheel::TimingWheel(const InnerEvent::TimePoint &now) : currentTick_(ToTick(now))
+{}
+
+uint64_t TimingWheel::ToTick(const InnerEvent::TimePoint &time)
+{
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+    return (ms > 0) ? static_cast<uint64_t>(ms) : 0;
+}
+
+std::list<TimingWheel::Entry> &TimingWheel::GetSlot(uint64_t tick)
+{
+    // Find the lowest level, in which the tick is in the same rotation with current tick.
+    for (uint32_t level = 0; level < LEVEL_NUM; ++level) {
+        uint32_t shift = LEVEL_BITS * (level + 1);
+        if ((tick >> shift) == (currentTick_ >> shift)) {
+            uint32_t index = static_cast<uint32_t>((tick >> (LEVEL_BITS * level)) & SLOT_MASK);
+            occupied_[level] |= (1ULL << index);
+            return slots_[level][index];
+        }
+    }
+    return overflow_;
+}
+
+bool TimingWheel::Add(InnerEvent::Pointer &event, uint32_t priority)
+{
+    uint64_t tick = ToTick(event->GetHandleTime());
+    if ((tick <= currentTick_) || (priority >= PRIORITY_NUM)) {
+        return false;
+    }
+    EventIndex::SetLocation(*event, EventLocation::TIMING_WHEEL);
+    GetSlot(tick).emplace_back(Entry {tick, priority, std::move(event)});
+    ++size_;
+    ++counts_[priority];
+    return true;
+}
+
+uint64_t TimingWheel::GetNextTick() const
+{
+    // Slots in or before the current index of each level are always empty, so only check slots after it.
+    for (uint32_t level = 0; level < LEVEL_NUM; ++level) {
+        uint32_t shift = LEVEL_BITS * level;
+        uint64_t index = (currentTick_ >> shift) & SLOT_MASK;
+        uint64_t pending = (index == SLOT_MASK) ? 0 : (occupied_[level] & (~0ULL << (index + 1)));
+        if (pending != 0) {
+            uint64_t rotation = currentTick_ >> (shift + LEVEL_BITS);
+            uint64_t next = static_cast<uint64_t>(__builtin_ctzll(pending));
+            return ((rotation << LEVEL_BITS) | next) << shift;
+        }
+    }
+    if (!overflow_.empty()) {
+        uint32_t shift = LEVEL_BITS * LEVEL_NUM;
+        return ((currentTick_ >> shift) + 1) << shift;
+    }
+    return UINT64_MAX;
+}
+
+InnerEvent::TimePoint TimingWheel::GetNextExpireTime() const
+{
+    uint64_t tick = GetNextTick();
+    if (tick >= MAX_TICK_IN_TIME_POINT) {
+        return InnerEvent::TimePoint::max();
+    }
+    return InnerEvent::TimePoint(std::chrono::milliseconds(tick));
+}
+
+void TimingWheel::Cascade(std::list<Entry> &slot, std::list<Entry> &expired)
+{
+    std::list<Entry> entries;
+    entries.swap(slot);
+    while (!entries.empty()) {
+        auto it = entries.begin();
+        if (EventIndex::IsDiscarded(*it->event)) {
+            --discardedCount_;
+            entries.erase(it);
+        } else if (it->tick <= currentTick_) {
+            --size_;
+            --counts_[it->priority];
+            expired.splice(expired.end(), entries, it);
+        } else {
+            auto &target = GetSlot(it->tick);
+            target.splice(target.end(), entries, it);
+        }
+    }
+}
+
+void TimingWheel::Advance(const InnerEvent::TimePoint &now, std::list<Entry> &expired)
+{
+    uint64_t nowTick = ToTick(now);
+    while ((size_ + discardedCount_) > 0) {
+        // Jump to the next tick which holds events directly, instead of turning tick by tick.
+        uint64_t next = GetNextTick();
+        if (next > nowTick) {
+            break;
+        }
+        currentTick_ = next;
+
+        // Cascade from the highest level, so that events moved down could be handled in this turn.
+        if ((currentTick_ & ((1ULL << (LEVEL_BITS * LEVEL_NUM)) - 1)) == 0) {
+            Cascade(overflow_, expired);
+        }
+        for (uint32_t level = LEVEL_NUM; level-- > 0;) {
+            uint32_t shift = LEVEL_BITS * level;
+            if ((currentTick_ & ((1ULL << shift) - 1)) != 0) {
+                continue;
+            }
+            uint32_t index = static_cast<uint32_t>((currentTick_ >> shift) & SLOT_MASK);
+            if ((occupied_[level] & (1ULL << index)) != 0) {
+                occupied_[level] &= ~(1ULL << index);
+                Cascade(slots_[level][index], expired);
+            }
+        }
+    }
+    if (nowTick > currentTick_) {
+        currentTick_ = nowTick;
+    }
+}
+
+bool TimingWheel::HasIf(const Filter &filter) const
+{
+    return VisitSlots([&filter](const std::list<Entry> &slot) {
+        return std::any_of(slot.begin(), slot.end(), [&filter](const Entry &entry) {
+            return !EventIndex::IsDiscarded(*entry.event) && filter(entry.event);
+        });
+    });
+}
+
+void TimingWheel::RemoveIf(const Filter &filter)
+{
+    std::list<InnerEvent::Pointer> events;
+    MoveIf(filter, events);
+}
+
+void TimingWheel::MoveIf(const Filter &filter, std::list<InnerEvent::Pointer> &events)
+{
+    auto moveFromSlot = [this, &filter, &events](std::list<Entry> &slot) {
+        for (auto it = slot.begin(); it != slot.end();) {
+            if (EventIndex::IsDiscarded(*it->event)) {
+                // Discarded events are dropped together, and never moved out.
+                it = slot.erase(it);
+            } else if (filter(it->event)) {
+                --size_;
+                --counts_[it->priority];
+                events.emplace_back(std::move(it->event));
+                it = slot.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        return slot.empty();
+    };
+
+    for (uint32_t level = 0; level < LEVEL_NUM; ++level) {
+        uint64_t occupied = occupied_[level];
+        while (occupied != 0) {
+            uint32_t index = static_cast<uint32_t>(__builtin_ctzll(occupied));
+            occupied &= occupied - 1;
+            if (moveFromSlot(slots_[level][index])) {
+                occupied_[level] &= ~(1ULL << index);
+            }
+        }
+    }
+    moveFromSlot(overflow_);
+    discardedCount_ = 0;
+}
+
+void TimingWheel::Clear()
+{
+    for (uint32_t level = 0; level < LEVEL_NUM; ++level) {
+        for (auto &slot : slots_[level]) {
+            slot.clear();
+        }
+        occupied_[level] = 0;
+    }
+    overflow_.clear();
+    size_ = 0;
+    counts_.fill(0);
+    discardedCount_ = 0;
+}
+
+void TimingWheel::MarkDiscarded(uint32_t priority)
+{
+    if (priority >= PRIORITY_NUM) {
+        return;
+    }
+    --size_;
+    --counts_[priority];
+    ++discardedCount_;
+}
+}  // namespace AppExecFwk
+}  // namespace OHOS
@@ -15,15 +15,20 @@
 
 #include <gtest/gtest.h>
 
+#include <chrono>
 #include <cstdlib>
+#include <map>
 #include <vector>
 
+#include <unistd.h>
+
 #include "event_handler.h"
 #include "event_queue.h"
 #include "event_runner.h"
 #include "epoll_io_waiter.h"
 #include "deamon_io_waiter.h"
 #include "none_io_waiter.h"
+#include "std_lock.h"
 
 using namespace testing::ext;
 using namespace OHOS::AppExecFwk;
@@ -240,4 +245,185 @@ HWTEST_F(LibEventHandlerEpollIoWaiterTest, NoneIoWaiter001, TestSize.Level1)
     auto listener = std::make_shared<IoFileDescriptorListener>();
     bool result = ioWaiter.AddFileDescriptor(1, 2, "task", listener, EventQueue::Priority::VIP);
     EXPECT_EQ(result, false);
-}
\ No newline at end of file
+}
+/*
+ * @tc.name: HighResolution001
+ * @tc.desc: Epoll waiter times out with precision below one millisecond, by epoll_pwait2 or timer fd
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEpollIoWaiterTest, HighResolution001, TestSize.Level1)
+{
+    constexpr int64_t timeout = 300000;
+    EpollIoWaiter ioWaiter;
+    ASSERT_TRUE(ioWaiter.Init());
+    StdLock queueLock;
+    UniqueLockBase lock(queueLock);
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, timeout));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::milliseconds(1));
+
+    ioWaiter.EnableHighResolution();
+    start = std::chrono::steady_clock::now();
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, timeout));
+    elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_GE(elapsed, std::chrono::nanoseconds(timeout));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1));
+
+    struct epoll_event events[1];
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(ioWaiter.WaitWithTimer(events, 1, timeout), 1);
+    elapsed = std::chrono::steady_clock::now() - start;
+    EXPECT_EQ(events[0].data.ptr, &ioWaiter.timerFd_);
+    EXPECT_GE(elapsed, std::chrono::nanoseconds(timeout));
+    EXPECT_LT(elapsed, std::chrono::milliseconds(1));
+    ioWaiter.DrainTimer();
+}
+
+/*
+ * @tc.name: MaxEventsPerWait001
+ * @tc.desc: Epoll waiter takes events of all ready file descriptors by one wait, unless the count is set
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEpollIoWaiterTest, MaxEventsPerWait001, TestSize.Level1)
+{
+    constexpr size_t pipeCount = 20;
+    constexpr uint32_t maxEvents = 4;
+    EpollIoWaiter ioWaiter;
+    ASSERT_TRUE(ioWaiter.Init());
+    size_t reportedCount = 0;
+    ioWaiter.SetFileDescriptorEventCallback([&reportedCount](int32_t, uint32_t, const std::string &,
+        EventQueue::Priority, const std::shared_ptr<FileDescriptorListener> &) { ++reportedCount; });
+
+    std::vector<int32_t> fds;
+    auto listener = std::make_shared<IoFileDescriptorListener>();
+    for (size_t i = 0; i < pipeCount; ++i) {
+        int32_t pipeFds[2] = {-1, -1};
+        ASSERT_EQ(pipe(pipeFds), 0);
+        ASSERT_EQ(write(pipeFds[1], "x", 1), 1);
+        EXPECT_TRUE(ioWaiter.AddFileDescriptor(pipeFds[0], FILE_DESCRIPTOR_INPUT_EVENT, "MaxEventsPerWait001",
+            listener, EventQueue::Priority::HIGH));
+        fds.push_back(pipeFds[0]);
+        fds.push_back(pipeFds[1]);
+    }
+
+    StdLock queueLock;
+    UniqueLockBase lock(queueLock);
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    EXPECT_EQ(reportedCount, pipeCount);
+
+    ioWaiter.SetMaxEventsPerWait(maxEvents);
+    reportedCount = 0;
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    EXPECT_EQ(reportedCount, maxEvents);
+
+    for (int32_t fd : fds) {
+        close(fd);
+    }
+}
+
+/*
+ * @tc.name: ListeningMode001
+ * @tc.desc: File descriptors listened in edge triggered or one-shot mode are not reported again until changed
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEpollIoWaiterTest, ListeningMode001, TestSize.Level1)
+{
+    EpollIoWaiter ioWaiter;
+    ASSERT_TRUE(ioWaiter.Init());
+    std::map<int32_t, uint32_t> reportedEvents;
+    ioWaiter.SetFileDescriptorEventCallback([&reportedEvents](int32_t fileDescriptor, uint32_t events,
+        const std::string &, EventQueue::Priority, const std::shared_ptr<FileDescriptorListener> &) {
+        reportedEvents[fileDescriptor] = events;
+    });
+
+    int32_t edgeFds[2] = {-1, -1};
+    int32_t oneshotFds[2] = {-1, -1};
+    ASSERT_EQ(pipe(edgeFds), 0);
+    ASSERT_EQ(pipe(oneshotFds), 0);
+    auto listener = std::make_shared<IoFileDescriptorListener>();
+    EXPECT_TRUE(ioWaiter.AddFileDescriptor(edgeFds[0], FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_EDGE_TRIGGERED,
+        "ListeningMode001", listener, EventQueue::Priority::HIGH));
+    EXPECT_TRUE(ioWaiter.AddFileDescriptor(oneshotFds[0], FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_ONESHOT,
+        "ListeningMode001", listener, EventQueue::Priority::HIGH));
+    ASSERT_EQ(write(edgeFds[1], "x", 1), 1);
+    ASSERT_EQ(write(oneshotFds[1], "x", 1), 1);
+
+    StdLock queueLock;
+    UniqueLockBase lock(queueLock);
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    ASSERT_EQ(reportedEvents.size(), 2);
+    EXPECT_EQ(reportedEvents[edgeFds[0]], FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_EDGE_TRIGGERED);
+    EXPECT_EQ(reportedEvents[oneshotFds[0]], FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_ONESHOT);
+
+    // Both are still readable, but not reported again.
+    reportedEvents.clear();
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    EXPECT_TRUE(reportedEvents.empty());
+
+    // One-shot listening is resumed by rearming.
+    EXPECT_TRUE(ioWaiter.RearmFileDescriptor(oneshotFds[0]));
+    EXPECT_FALSE(ioWaiter.RearmFileDescriptor(-1));
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    ASSERT_EQ(reportedEvents.size(), 1);
+    EXPECT_EQ(reportedEvents[oneshotFds[0]], FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_ONESHOT);
+
+    for (int32_t fd : {edgeFds[0], edgeFds[1], oneshotFds[0], oneshotFds[1]}) {
+        close(fd);
+    }
+}
+
+/*
+ * @tc.name: RetireRecord001
+ * @tc.desc: Record of removed file descriptor is kept until threads which may hold it have left waiting
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEpollIoWaiterTest, RetireRecord001, TestSize.Level1)
+{
+    EpollIoWaiter ioWaiter;
+    ASSERT_TRUE(ioWaiter.Init());
+    std::shared_ptr<FileDescriptorListener> reportedListener;
+    ioWaiter.SetFileDescriptorEventCallback([&reportedListener](int32_t, uint32_t, const std::string &,
+        EventQueue::Priority, const std::shared_ptr<FileDescriptorListener> &listener) {
+        reportedListener = listener;
+    });
+
+    int32_t fds[2] = {-1, -1};
+    ASSERT_EQ(pipe(fds), 0);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    auto listener = std::make_shared<IoFileDescriptorListener>();
+    std::weak_ptr<FileDescriptorListener> weakListener = listener;
+    EXPECT_TRUE(ioWaiter.AddFileDescriptor(fds[0], FILE_DESCRIPTOR_INPUT_EVENT, "RetireRecord001", listener,
+        EventQueue::Priority::HIGH));
+
+    StdLock queueLock;
+    UniqueLockBase lock(queueLock);
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    EXPECT_EQ(reportedListener, listener);
+    reportedListener.reset();
+    listener.reset();
+
+    // Removed while another thread is waiting, so the record is retired.
+    ioWaiter.EnterWaiting();
+    ioWaiter.RemoveFileDescriptor(fds[0]);
+    EXPECT_EQ(ioWaiter.retired_.size(), 1);
+    EXPECT_FALSE(weakListener.expired());
+    EXPECT_TRUE(ioWaiter.WaitFor(lock, 0));
+    EXPECT_FALSE(weakListener.expired());
+    ioWaiter.LeaveWaiting();
+    EXPECT_TRUE(ioWaiter.retired_.empty());
+    EXPECT_TRUE(weakListener.expired());
+
+    // Released at once if nobody is waiting.
+    listener = std::make_shared<IoFileDescriptorListener>();
+    weakListener = listener;
+    EXPECT_TRUE(ioWaiter.AddFileDescriptor(fds[0], FILE_DESCRIPTOR_INPUT_EVENT, "RetireRecord001", listener,
+        EventQueue::Priority::HIGH));
+    listener.reset();
+    ioWaiter.RemoveFileDescriptor(fds[0]);
+    EXPECT_TRUE(ioWaiter.retired_.empty());
+    EXPECT_TRUE(weakListener.expired());
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -16,7 +16,9 @@
 #include <cstdint>
 #include <gtest/gtest.h>
 
+#include <atomic>
 #include <chrono>
+#include <future>
 #include <string>
 #include <thread>
 
@@ -3117,3 +3119,743 @@ HWTEST_F(LibEventHandlerEventQueueTest, SetVsyncFirstForceEnableTimeTest_001, Te
     queue.SetVsyncFirstForceEnableTime(false, timeout);
     EXPECT_EQ(queue.vsyncFirstForceEnableEndTime_, 0);
 }
+
+/*
+ * @tc.name: SortedEventQueueTest_001
+ * @tc.desc: Events with the same handle time are got in order of insertion, delayed events are sorted
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, SortedEventQueueTest_001, TestSize.Level1)
+{
+    SortedEventQueue queue;
+    auto now = InnerEvent::Clock::now();
+    const uint32_t delayedEventId = 100;
+    for (uint32_t i = 0; i < NUM; ++i) {
+        auto event = InnerEvent::Get(delayedEventId - i);
+        event->SetSendTime(now);
+        event->SetHandleTime(now + std::chrono::milliseconds(DELAY_TIME - i));
+        queue.Insert(event);
+    }
+    for (uint32_t i = 0; i < NUM; ++i) {
+        auto event = InnerEvent::Get(i);
+        event->SetSendTime(now);
+        event->SetHandleTime(now);
+        queue.Insert(event);
+    }
+    EXPECT_EQ(queue.Size(), NUM + NUM);
+
+    for (uint32_t i = 0; i < NUM; ++i) {
+        EXPECT_EQ(queue.PopFront()->GetInnerEventId(), i);
+    }
+    for (uint32_t i = NUM; i > 0; --i) {
+        EXPECT_EQ(queue.PopFront()->GetInnerEventId(), delayedEventId - i + 1);
+    }
+    EXPECT_TRUE(queue.Empty());
+}
+
+/*
+ * @tc.name: SortedEventQueueTest_002
+ * @tc.desc: Event inserted at front is got first, and its handle time is not later than the head
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, SortedEventQueueTest_002, TestSize.Level1)
+{
+    SortedEventQueue queue;
+    auto now = InnerEvent::Clock::now();
+    auto event = InnerEvent::Get(REMOVE_EVENT_ID);
+    event->SetSendTime(now);
+    event->SetHandleTime(now);
+    queue.Insert(event);
+    auto delayedEvent = InnerEvent::Get(HAS_EVENT_ID);
+    delayedEvent->SetSendTime(now);
+    delayedEvent->SetHandleTime(now - std::chrono::milliseconds(DELAY_TIME));
+    queue.Insert(delayedEvent);
+    auto frontEvent = InnerEvent::Get(INSERT_DELAY);
+    frontEvent->SetSendTime(now);
+    frontEvent->SetHandleTime(now + std::chrono::milliseconds(DELAY_TIME));
+    queue.Insert(frontEvent, EventInsertType::AT_FRONT);
+
+    EXPECT_EQ(queue.Front()->GetHandleTime(), now - std::chrono::milliseconds(DELAY_TIME));
+    EXPECT_EQ(queue.PopFront()->GetInnerEventId(), INSERT_DELAY);
+    EXPECT_EQ(queue.PopFront()->GetInnerEventId(), HAS_EVENT_ID);
+    EXPECT_EQ(queue.PopFront()->GetInnerEventId(), REMOVE_EVENT_ID);
+}
+
+/*
+ * @tc.name: SortedEventQueueTest_003
+ * @tc.desc: Pop the first matched event in order of handle time, and remove matched events
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, SortedEventQueueTest_003, TestSize.Level1)
+{
+    SortedEventQueue queue;
+    auto now = InnerEvent::Clock::now();
+    for (uint32_t i = 0; i < HIGH_PRIORITY_COUNT; ++i) {
+        auto event = InnerEvent::Get(i, static_cast<int64_t>(i % NUM));
+        event->SetSendTime(now);
+        event->SetHandleTime(now + std::chrono::milliseconds(HIGH_PRIORITY_COUNT - i));
+        queue.Insert(event);
+    }
+    auto filter = [](const InnerEvent::Pointer &p) { return p->GetParam() == 0; };
+    auto event = queue.PopFirst(filter);
+    ASSERT_NE(event, nullptr);
+    EXPECT_EQ(event->GetInnerEventId(), HIGH_PRIORITY_COUNT - NUM);
+    EXPECT_TRUE(queue.HasIf(filter));
+
+    queue.RemoveIf(filter);
+    EXPECT_FALSE(queue.HasIf(filter));
+    EXPECT_EQ(queue.Size(), HIGH_PRIORITY_COUNT / NUM);
+    uint32_t lastId = HIGH_PRIORITY_COUNT;
+    queue.ForEach([&lastId](const InnerEvent::Pointer &p) {
+        EXPECT_LT(p->GetInnerEventId(), lastId);
+        lastId = p->GetInnerEventId();
+    });
+}
+
+/*
+ * @tc.name: SortedEventQueueTest_004
+ * @tc.desc: Events inserted in batches are sorted together with events inserted one by one
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, SortedEventQueueTest_004, TestSize.Level1)
+{
+    SortedEventQueue queue;
+    auto now = InnerEvent::Clock::now();
+    auto createEvent = [now](uint32_t id, int64_t delay) {
+        auto event = InnerEvent::Get(id);
+        event->SetSendTime(now);
+        event->SetHandleTime(now + std::chrono::milliseconds(delay));
+        return event;
+    };
+    for (uint32_t i = 0; i < HIGH_PRIORITY_COUNT; ++i) {
+        auto event = createEvent(i * NUM, i + 1);
+        queue.Insert(event);
+    }
+
+    // A small batch is pushed into heap one by one, and a large batch rebuilds the heap.
+    const uint32_t batchSizes[] = {1, HIGH_PRIORITY_COUNT * NUM};
+    for (uint32_t batchSize : batchSizes) {
+        std::vector<InnerEvent::Pointer> events;
+        for (uint32_t i = 0; i < batchSize; ++i) {
+            events.emplace_back(createEvent((HIGH_PRIORITY_COUNT + i) * NUM, 0));
+            events.emplace_back(createEvent((i % HIGH_PRIORITY_COUNT) * NUM + 1, (i % HIGH_PRIORITY_COUNT) + 1));
+        }
+        queue.InsertBatch(events);
+        EXPECT_EQ(events.size(), batchSize + batchSize);
+        EXPECT_EQ(events.front(), nullptr);
+    }
+    EXPECT_EQ(queue.Size(), HIGH_PRIORITY_COUNT + (HIGH_PRIORITY_COUNT * NUM + 1) * 2);
+
+    auto last = queue.PopFront();
+    EXPECT_EQ(last->GetInnerEventId(), HIGH_PRIORITY_COUNT * NUM);
+    while (!queue.Empty()) {
+        auto event = queue.PopFront();
+        EXPECT_LE(last->GetHandleTime(), event->GetHandleTime());
+        if (last->GetHandleTime() == event->GetHandleTime()) {
+            // Events with the same handle time are kept in order of insertion.
+            EXPECT_LE(last->GetInnerEventId() % NUM, event->GetInnerEventId() % NUM);
+        }
+        last = std::move(event);
+    }
+}
+
+/*
+ * @tc.name: TimingWheelTest_001
+ * @tc.desc: Events in timing wheel are handed out after their tick, including events in higher levels
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, TimingWheelTest_001, TestSize.Level1)
+{
+    auto now = InnerEvent::TimePoint(std::chrono::milliseconds(1));
+    TimingWheel wheel(now);
+    const int64_t delays[] = {DELAY_TIME, REMOVE_DELAY_TIME, REMOVE_WAIT_TIME, 24 * 3600 * 1000, REMOVE_DELAY_TIME};
+    const uint32_t count = sizeof(delays) / sizeof(delays[0]);
+    for (uint32_t i = 0; i < count; ++i) {
+        auto event = InnerEvent::Get(i);
+        event->SetSendTime(now);
+        event->SetHandleTime(now + std::chrono::milliseconds(delays[i]));
+        EXPECT_TRUE(wheel.Add(event, static_cast<uint32_t>(EventQueue::Priority::LOW)));
+    }
+    auto expiredEvent = InnerEvent::Get(count);
+    expiredEvent->SetHandleTime(now);
+    EXPECT_FALSE(wheel.Add(expiredEvent, static_cast<uint32_t>(EventQueue::Priority::LOW)));
+    EXPECT_NE(expiredEvent, nullptr);
+    EXPECT_EQ(wheel.Size(), count);
+    EXPECT_EQ(wheel.Size(static_cast<uint32_t>(EventQueue::Priority::LOW)), count);
+    EXPECT_EQ(wheel.GetNextExpireTime(), now + std::chrono::milliseconds(REMOVE_DELAY_TIME));
+
+    std::list<TimingWheel::Entry> expired;
+    wheel.Advance(now + std::chrono::milliseconds(REMOVE_DELAY_TIME - 1), expired);
+    EXPECT_TRUE(expired.empty());
+    wheel.Advance(now + std::chrono::milliseconds(REMOVE_WAIT_TIME), expired);
+    std::vector<uint32_t> ids;
+    for (const auto &entry : expired) {
+        ids.emplace_back(entry.event->GetInnerEventId());
+    }
+    EXPECT_EQ(ids, std::vector<uint32_t>({1, 4, 0, 2}));
+
+    expired.clear();
+    wheel.Advance(now + std::chrono::milliseconds(delays[3] - 1), expired);
+    EXPECT_TRUE(expired.empty());
+    EXPECT_EQ(wheel.GetNextExpireTime(), now + std::chrono::milliseconds(delays[3]));
+    wheel.Advance(now + std::chrono::milliseconds(delays[3]), expired);
+    ASSERT_EQ(expired.size(), 1);
+    EXPECT_EQ(expired.front().event->GetInnerEventId(), 3);
+    EXPECT_TRUE(wheel.Empty());
+    EXPECT_EQ(wheel.GetNextExpireTime(), InnerEvent::TimePoint::max());
+}
+
+/*
+ * @tc.name: TimingWheelTest_002
+ * @tc.desc: Delayed events in timing wheel could be found, removed and got in order of handle time
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, TimingWheelTest_002, TestSize.Level1)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.EnableTimingWheel();
+    queue.Prepare();
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto now = InnerEvent::Clock::now();
+    for (uint32_t i = 0; i < NUM; ++i) {
+        auto event = InnerEvent::Get(HAS_EVENT_ID + i);
+        event->SetOwner(handler);
+        event->SetOwnerNumericId(handler->GetHandlerNumericId());
+        event->SetSendTime(now);
+        event->SetHandleTime(now + std::chrono::milliseconds(REMOVE_DELAY_TIME + NUM - i));
+        queue.Insert(event, EventQueue::Priority::HIGH);
+    }
+    auto removedEvent = InnerEvent::Get(REMOVE_EVENT_ID);
+    removedEvent->SetOwner(handler);
+    removedEvent->SetOwnerNumericId(handler->GetHandlerNumericId());
+    removedEvent->SetSendTime(now);
+    removedEvent->SetHandleTime(now + std::chrono::milliseconds(REMOVE_DELAY_TIME));
+    queue.Insert(removedEvent, EventQueue::Priority::HIGH);
+    EXPECT_EQ(queue.timingWheel_->Size(), NUM + 1);
+    EXPECT_FALSE(queue.IsQueueEmpty());
+    EXPECT_TRUE(queue.HasInnerEvent(handler, REMOVE_EVENT_ID));
+
+    queue.Remove(handler, REMOVE_EVENT_ID);
+    EXPECT_FALSE(queue.HasInnerEvent(handler, REMOVE_EVENT_ID));
+    InnerEvent::TimePoint nextExpiredTime = InnerEvent::TimePoint::max();
+    EXPECT_EQ(queue.GetExpiredEvent(nextExpiredTime), nullptr);
+    EXPECT_LE(nextExpiredTime, now + std::chrono::milliseconds(REMOVE_DELAY_TIME + 1));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(REMOVE_DELAY_TIME + NUM + 1));
+    for (uint32_t i = NUM; i > 0; --i) {
+        auto event = queue.GetExpiredEvent(nextExpiredTime);
+        ASSERT_NE(event, nullptr);
+        EXPECT_EQ(event->GetInnerEventId(), HAS_EVENT_ID + i - 1);
+    }
+    EXPECT_TRUE(queue.IsQueueEmpty());
+}
+
+/*
+ * @tc.name: TimingWheelTest_003
+ * @tc.desc: Delayed tasks run on event runner created with timing wheel, removed tasks never run
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, TimingWheelTest_003, TestSize.Level1)
+{
+    EventRunnerOptions options;
+    options.useTimingWheel = true;
+    auto runner = EventRunner::Create(std::string("TimingWheelTest_003"), options);
+    ASSERT_NE(runner, nullptr);
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::atomic<uint32_t> count(0);
+    std::atomic<bool> removedTaskRan(false);
+    for (uint32_t i = 0; i < HIGH_PRIORITY_COUNT; ++i) {
+        handler->PostTask([&count]() { ++count; }, std::to_string(i), REMOVE_DELAY_TIME + i);
+    }
+    handler->PostTask([&removedTaskRan]() { removedTaskRan.store(true); }, "removed", REMOVE_DELAY_TIME);
+    handler->RemoveTask("removed");
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_TIME));
+    EXPECT_EQ(count.load(), HIGH_PRIORITY_COUNT);
+    EXPECT_FALSE(removedTaskRan.load());
+}
+
+namespace {
+InnerEvent::Pointer CreateIndexedEvent(const std::shared_ptr<EventHandler> &handler, uint32_t innerEventId,
+    int64_t param, int64_t delayTime)
+{
+    auto event = InnerEvent::Get(innerEventId, param);
+    auto now = InnerEvent::Clock::now();
+    event->SetOwner(handler);
+    event->SetOwnerNumericId(handler->GetHandlerNumericId());
+    event->SetSendTime(now);
+    event->SetHandleTime(now + std::chrono::milliseconds(delayTime));
+    return event;
+}
+
+InnerEvent::Pointer CreateIndexedTask(const std::shared_ptr<EventHandler> &handler, const InnerEvent::Callback &task,
+    const std::string &name, int64_t delayTime)
+{
+    auto event = InnerEvent::Get(task, name);
+    auto now = InnerEvent::Clock::now();
+    event->SetOwner(handler);
+    event->SetOwnerNumericId(handler->GetHandlerNumericId());
+    event->SetSendTime(now);
+    event->SetHandleTime(now + std::chrono::milliseconds(delayTime));
+    return event;
+}
+}  // unnamed namespace
+
+/*
+ * @tc.name: EventIndexTest_001
+ * @tc.desc: Remove and find events by owner, event id, param and task name through indexes
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, EventIndexTest_001, TestSize.Level1)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.Prepare();
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto otherHandler = std::make_shared<EventHandler>(runner);
+    auto task = []() {};
+    for (uint32_t i = 0; i < HIGH_PRIORITY_COUNT; ++i) {
+        auto event = CreateIndexedEvent(handler, HAS_EVENT_ID + (i % NUM), HAS_EVENT_PARAM + i, 0);
+        queue.Insert(event, EventQueue::Priority::HIGH);
+        auto delayedEvent = CreateIndexedEvent(handler, REMOVE_EVENT_ID, HAS_EVENT_PARAM, REMOVE_DELAY_TIME + i);
+        queue.Insert(delayedEvent, EventQueue::Priority::LOW);
+        auto otherEvent = CreateIndexedEvent(otherHandler, REMOVE_EVENT_ID, HAS_EVENT_PARAM, 0);
+        queue.Insert(otherEvent, EventQueue::Priority::HIGH);
+    }
+    auto removedTask = CreateIndexedTask(handler, task, "removed", 0);
+    queue.Insert(removedTask, EventQueue::Priority::IDLE);
+    auto keptTask = CreateIndexedTask(handler, task, "kept", 0);
+    queue.Insert(keptTask, EventQueue::Priority::IDLE);
+
+    EXPECT_TRUE(queue.Remove(handler, "removed"));
+    EXPECT_FALSE(queue.Remove(handler, "removed"));
+    EXPECT_FALSE(queue.Remove(otherHandler, "kept"));
+    EXPECT_EQ(queue.idleEvents_.Size(), 1);
+
+    EXPECT_TRUE(queue.HasInnerEvent(handler, HAS_EVENT_PARAM + 1));
+    queue.Remove(handler, HAS_EVENT_ID + 1, HAS_EVENT_PARAM + 1);
+    EXPECT_FALSE(queue.HasInnerEvent(handler, HAS_EVENT_PARAM + 1));
+    EXPECT_TRUE(queue.HasInnerEvent(handler, HAS_EVENT_ID + 1));
+    queue.Remove(handler, HAS_EVENT_ID + 1);
+    EXPECT_FALSE(queue.HasInnerEvent(handler, HAS_EVENT_ID + 1));
+    EXPECT_EQ(queue.subEventQueues_[static_cast<uint32_t>(EventQueue::Priority::HIGH)].queue.Size(),
+        HIGH_PRIORITY_COUNT + HIGH_PRIORITY_COUNT / NUM);
+
+    queue.Remove(handler, REMOVE_EVENT_ID);
+    EXPECT_TRUE(queue.subEventQueues_[static_cast<uint32_t>(EventQueue::Priority::LOW)].queue.Empty());
+    EXPECT_TRUE(queue.HasInnerEvent(otherHandler, REMOVE_EVENT_ID));
+
+    // Discarded events are skipped while getting events.
+    InnerEvent::TimePoint nextExpiredTime = InnerEvent::TimePoint::max();
+    uint32_t eventCount = 0;
+    uint32_t otherEventCount = 0;
+    for (auto event = queue.GetExpiredEvent(nextExpiredTime); event; event = queue.GetExpiredEvent(nextExpiredTime)) {
+        if (event->GetOwnerNumericId() == otherHandler->GetHandlerNumericId()) {
+            ++otherEventCount;
+            continue;
+        }
+        ++eventCount;
+        if (!event->HasTask()) {
+            EXPECT_EQ(event->GetInnerEventId(), HAS_EVENT_ID);
+        }
+    }
+    EXPECT_EQ(eventCount, HIGH_PRIORITY_COUNT / NUM + 1);
+    EXPECT_EQ(otherEventCount, HIGH_PRIORITY_COUNT);
+    EXPECT_TRUE(queue.IsQueueEmpty());
+    EXPECT_FALSE(queue.HasInnerEvent(handler, HAS_EVENT_ID));
+}
+
+/*
+ * @tc.name: EventIndexTest_002
+ * @tc.desc: Payload of removed events is released at once, also for events in timing wheel
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, EventIndexTest_002, TestSize.Level1)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.EnableTimingWheel();
+    queue.Prepare();
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto payload = std::make_shared<uint32_t>(0);
+    for (uint32_t i = 0; i < NUM; ++i) {
+        auto event = CreateIndexedTask(handler, [payload]() { ++(*payload); }, "wheel", DELAY_TIME + i);
+        queue.Insert(event, EventQueue::Priority::HIGH);
+        auto immediateTask = CreateIndexedTask(handler, [payload]() { ++(*payload); }, "immediate", 0);
+        queue.Insert(immediateTask, EventQueue::Priority::IMMEDIATE);
+    }
+    auto keptEvent = CreateIndexedEvent(handler, HAS_EVENT_ID, HAS_EVENT_PARAM, REMOVE_DELAY_TIME);
+    queue.Insert(keptEvent, EventQueue::Priority::HIGH);
+    EXPECT_EQ(payload.use_count(), NUM + NUM + 1);
+    EXPECT_EQ(queue.timingWheel_->Size(), NUM + 1);
+
+    EXPECT_TRUE(queue.Remove(handler, "wheel"));
+    EXPECT_EQ(payload.use_count(), NUM + 1);
+    EXPECT_EQ(queue.timingWheel_->Size(), 1);
+    EXPECT_TRUE(queue.Remove(handler, "immediate"));
+    EXPECT_EQ(payload.use_count(), 1);
+    EXPECT_TRUE(queue.subEventQueues_[static_cast<uint32_t>(EventQueue::Priority::IMMEDIATE)].queue.Empty());
+
+    // Discarded events in timing wheel are dropped while turning, only the kept event expires.
+    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_TIME + NUM));
+    InnerEvent::TimePoint nextExpiredTime = InnerEvent::TimePoint::max();
+    auto event = queue.GetExpiredEvent(nextExpiredTime);
+    ASSERT_NE(event, nullptr);
+    EXPECT_EQ(event->GetInnerEventId(), HAS_EVENT_ID);
+    EXPECT_EQ(queue.GetExpiredEvent(nextExpiredTime), nullptr);
+    EXPECT_TRUE(queue.timingWheel_->Empty());
+    EXPECT_TRUE(queue.IsQueueEmpty());
+    EXPECT_EQ(*payload, 0);
+}
+
+/*
+ * @tc.name: EventIndexTest_003
+ * @tc.desc: Indexed tasks of handlers are removed by RemoveAll, and the runner is destroyed with its queue emptied
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, EventIndexTest_003, TestSize.Level1)
+{
+    auto payload = std::make_shared<uint32_t>(0);
+    for (bool useTimingWheel : {false, true}) {
+        EventRunnerOptions options;
+        options.useTimingWheel = useTimingWheel;
+        auto runner = EventRunner::Create(std::string("EventIndexTest_003"), options);
+        auto handler = std::make_shared<EventHandler>(runner);
+        // Keep the runner busy, so that immediate tasks stay in the queue.
+        std::promise<void> blocked;
+        std::promise<void> released;
+        auto releasedFuture = released.get_future().share();
+        EXPECT_TRUE(handler->PostTask([&blocked, releasedFuture]() {
+            blocked.set_value();
+            releasedFuture.wait();
+        }));
+        blocked.get_future().wait();
+        for (uint32_t i = 0; i < NUM; ++i) {
+            EXPECT_TRUE(handler->PostTask([payload]() { ++(*payload); }, "immediate", 0));
+            EXPECT_TRUE(handler->PostTask([payload]() { ++(*payload); }, "delayed", DELAY_TIME + i));
+        }
+        EXPECT_TRUE(handler->PostTask([payload]() { ++(*payload); }, "idle", 0, EventQueue::Priority::IDLE));
+        EXPECT_EQ(payload.use_count(), NUM + NUM + 2);
+
+        runner->GetEventQueue()->RemoveAll();
+        EXPECT_EQ(payload.use_count(), 1);
+        EXPECT_TRUE(runner->GetEventQueue()->IsQueueEmpty());
+        released.set_value();
+        handler.reset();
+        runner.reset();
+    }
+    EXPECT_EQ(*payload, 0);
+}
+
+/*
+ * @tc.name: IngressQueueTest_001
+ * @tc.desc: Events posted through ingress queue are taken in order of posting, and could be found and removed
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, IngressQueueTest_001, TestSize.Level1)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.EnableIngressQueue();
+    queue.Prepare();
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    for (uint32_t i = 0; i < HIGH_PRIORITY_COUNT; ++i) {
+        auto event = CreateIndexedEvent(handler, HAS_EVENT_ID + i, 0, 0);
+        EXPECT_TRUE(queue.Insert(event, EventQueue::Priority::HIGH));
+    }
+    auto removedEvent = CreateIndexedEvent(handler, REMOVE_EVENT_ID, 0, 0);
+    EXPECT_TRUE(queue.Insert(removedEvent, EventQueue::Priority::HIGH));
+    EXPECT_FALSE(queue.ingressQueue_->Empty());
+
+    EXPECT_TRUE(queue.HasInnerEvent(handler, REMOVE_EVENT_ID));
+    EXPECT_TRUE(queue.ingressQueue_->Empty());
+    queue.Remove(handler, REMOVE_EVENT_ID);
+    EXPECT_FALSE(queue.HasInnerEvent(handler, REMOVE_EVENT_ID));
+
+    // Event inserted to the front of queue directly is still ahead of events in ingress queue.
+    auto lastEvent = CreateIndexedEvent(handler, HAS_EVENT_ID + HIGH_PRIORITY_COUNT, 0, 0);
+    EXPECT_TRUE(queue.Insert(lastEvent, EventQueue::Priority::HIGH));
+    auto frontEvent = CreateIndexedEvent(handler, HAS_EVENT_ID - 1, 0, 0);
+    EXPECT_TRUE(queue.Insert(frontEvent, EventQueue::Priority::HIGH, EventInsertType::AT_FRONT));
+    InnerEvent::TimePoint nextExpiredTime = InnerEvent::TimePoint::max();
+    for (uint32_t i = 0; i <= HIGH_PRIORITY_COUNT + 1; ++i) {
+        auto event = queue.GetExpiredEvent(nextExpiredTime);
+        ASSERT_NE(event, nullptr);
+        EXPECT_EQ(event->GetInnerEventId(), HAS_EVENT_ID + i - 1);
+    }
+    EXPECT_TRUE(queue.IsQueueEmpty());
+}
+
+/*
+ * @tc.name: IngressQueueTest_002
+ * @tc.desc: Events left in ingress queue are removed by RemoveAll, and released while the queue is destroyed
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, IngressQueueTest_002, TestSize.Level1)
+{
+    auto payload = std::make_shared<int>(0);
+    {
+        EventQueueBase queue(EventLockType::STANDARD);
+        queue.EnableIngressQueue();
+        queue.Prepare();
+        auto event = InnerEvent::Get([payload]() { ++*payload; });
+        EXPECT_TRUE(queue.Insert(event, EventQueue::Priority::LOW));
+        queue.RemoveAll();
+        EXPECT_TRUE(queue.IsQueueEmpty());
+        EXPECT_EQ(payload.use_count(), 1);
+
+        auto leftEvent = InnerEvent::Get([payload]() { ++*payload; });
+        EXPECT_TRUE(queue.Insert(leftEvent, EventQueue::Priority::LOW));
+        EXPECT_EQ(payload.use_count(), NUM);
+    }
+    EXPECT_EQ(payload.use_count(), 1);
+    EXPECT_EQ(*payload, 0);
+}
+
+/*
+ * @tc.name: IngressQueueTest_003
+ * @tc.desc: Waiting runner is woken up by tasks posted through ingress queue, tasks of each thread run in order
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, IngressQueueTest_003, TestSize.Level1)
+{
+    EventRunnerOptions options;
+    options.useIngressQueue = true;
+    auto runner = EventRunner::Create(std::string("IngressQueueTest_003"), options);
+    ASSERT_NE(runner, nullptr);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    std::vector<std::vector<uint32_t>> results(NUM);
+    std::atomic<uint32_t> count(0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < NUM; ++t) {
+        threads.emplace_back([&handler, &results, &count, t]() {
+            for (uint32_t i = 0; i < IMMEDIATE_PRIORITY_COUNT; ++i) {
+                handler->PostTask([&results, &count, t, i]() {
+                    results[t].emplace_back(i);
+                    ++count;
+                });
+                if ((i % LOW_PRIORITY_COUNT) == 0) {
+                    // Let the runner fall asleep sometimes.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(DELAY_TIME));
+    EXPECT_EQ(count.load(), NUM * IMMEDIATE_PRIORITY_COUNT);
+    for (const auto &result : results) {
+        ASSERT_EQ(result.size(), IMMEDIATE_PRIORITY_COUNT);
+        for (uint32_t i = 0; i < IMMEDIATE_PRIORITY_COUNT; ++i) {
+            EXPECT_EQ(result[i], i);
+        }
+    }
+}
+
+class ReadingFileDescriptorListener : public FileDescriptorListener {
+public:
+    ReadingFileDescriptorListener() = default;
+    ~ReadingFileDescriptorListener() override = default;
+
+    void OnReadable(int32_t fileDescriptor) override
+    {
+        char buffer = 0;
+        (void)read(fileDescriptor, &buffer, sizeof(buffer));
+        readThread_ = std::this_thread::get_id();
+        readCount_.fetch_add(1);
+    }
+
+    std::atomic<uint32_t> readCount_ {0};
+    std::thread::id readThread_;
+};
+
+/*
+ * @tc.name: DirectDispatchTest_001
+ * @tc.desc: Listeners of direct dispatch are called before queued events, unless expired events have the same
+ *           or higher priority
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, DirectDispatchTest_001, TestSize.Level1)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.Prepare();
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto event = CreateIndexedEvent(handler, HAS_EVENT_ID, 0, 0);
+    EXPECT_TRUE(queue.Insert(event, EventQueue::Priority::HIGH));
+
+    auto listener = std::make_shared<ReadingFileDescriptorListener>();
+    uint32_t events = FILE_DESCRIPTOR_OUTPUT_EVENT | FILE_DESCRIPTOR_DIRECT_DISPATCH;
+    EXPECT_TRUE(queue.PushDirectFileDescriptorEvent(-1, events, EventQueue::Priority::LOW, listener));
+    EXPECT_TRUE(queue.PushDirectFileDescriptorEvent(-1, events, EventQueue::Priority::HIGH, listener));
+    EXPECT_TRUE(queue.PushDirectFileDescriptorEvent(-1, events, EventQueue::Priority::IMMEDIATE, listener));
+
+    UniqueLockBase lock(*queue.queueLock_);
+    EXPECT_TRUE(queue.DispatchDirectFileDescriptorEventsLocked(lock));
+    EXPECT_EQ(queue.directFileDescriptorEvents_.size(), 2);
+    EXPECT_FALSE(queue.DispatchDirectFileDescriptorEventsLocked(lock));
+    lock.unlock();
+
+    InnerEvent::TimePoint nextExpiredTime = InnerEvent::TimePoint::max();
+    auto expiredEvent = queue.GetExpiredEvent(nextExpiredTime);
+    ASSERT_NE(expiredEvent, nullptr);
+    EXPECT_EQ(expiredEvent->GetInnerEventId(), HAS_EVENT_ID);
+    // Both are called once the queued event is taken.
+    EXPECT_EQ(queue.GetExpiredEvent(nextExpiredTime), nullptr);
+    EXPECT_TRUE(queue.directFileDescriptorEvents_.empty());
+}
+
+/*
+ * @tc.name: DirectDispatchTest_002
+ * @tc.desc: Listener of direct dispatch is called by the running thread without posting a task
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, DirectDispatchTest_002, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(true);
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::thread::id runnerThread;
+    handler->PostSyncTask([&runnerThread]() { runnerThread = std::this_thread::get_id(); });
+
+    int32_t fds[2] = {-1, -1};
+    ASSERT_EQ(pipe(fds), 0);
+    auto listener = std::make_shared<ReadingFileDescriptorListener>();
+    EXPECT_EQ(handler->AddFileDescriptorListener(fds[0], FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_DIRECT_DISPATCH,
+        listener, "DirectDispatchTest_002"), ERR_OK);
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+
+    constexpr int32_t maxRetryCount = 1000;
+    for (int32_t i = 0; (i < maxRetryCount) && (listener->readCount_.load() == 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(listener->readCount_.load(), 1);
+    EXPECT_EQ(listener->readThread_, runnerThread);
+    handler->RemoveFileDescriptorListener(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+/*
+ * @tc.name: CoalesceTest_001
+ * @tc.desc: Events reported while a call of listener is pending are merged into it and counted
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, CoalesceTest_001, TestSize.Level1)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.Prepare();
+    constexpr int32_t fileDescriptor = 100;
+    uint32_t events = FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_COALESCED;
+    EXPECT_FALSE(queue.CoalesceFileDescriptorEvent(fileDescriptor, events));
+    EXPECT_TRUE(queue.CoalesceFileDescriptorEvent(fileDescriptor, events));
+    EXPECT_TRUE(queue.CoalesceFileDescriptorEvent(fileDescriptor,
+        FILE_DESCRIPTOR_OUTPUT_EVENT | FILE_DESCRIPTOR_COALESCED));
+    EXPECT_EQ(queue.coalescedFileDescriptorEvents_[fileDescriptor].coalescedCount, 2);
+
+    EXPECT_EQ(queue.TakeCoalescedFileDescriptorEvents(fileDescriptor, events),
+        events | FILE_DESCRIPTOR_OUTPUT_EVENT);
+    // Events reported after the call is started need another call.
+    EXPECT_FALSE(queue.CoalesceFileDescriptorEvent(fileDescriptor, events));
+    EXPECT_EQ(queue.TakeCoalescedFileDescriptorEvents(fileDescriptor, events), events);
+    EXPECT_EQ(queue.coalescedFileDescriptorEvents_[fileDescriptor].coalescedCount, 2);
+}
+
+/*
+ * @tc.name: CoalesceTest_002
+ * @tc.desc: Repeated readiness of a file descriptor leads to a single call while the runner is busy
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, CoalesceTest_002, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(true);
+    auto handler = std::make_shared<EventHandler>(runner);
+    int32_t fds[] = {-1, -1};
+    ASSERT_EQ(pipe(fds), 0);
+    auto listener = std::make_shared<ReadingFileDescriptorListener>();
+    std::atomic<bool> blocked {true};
+    handler->PostTask([&blocked]() {
+        while (blocked.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    uint32_t events = FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_COALESCED;
+    EXPECT_EQ(handler->AddFileDescriptorListener(fds[0], events, listener, "CoalesceTest_002"), ERR_OK);
+
+    // Report readiness repeatedly, as level triggered waits do until the listener reads.
+    ASSERT_EQ(write(fds[1], "x", 1), 1);
+    auto queue = runner->GetEventQueue();
+    constexpr int32_t reportCount = 5;
+    for (int32_t i = 0; i < reportCount; ++i) {
+        queue->DispatchFileDescriptorEvent(fds[0], events, "CoalesceTest_002", EventQueue::Priority::HIGH, listener);
+    }
+    EXPECT_GE(handler->QueryPendingTaskInfo(fds[0]).coalescedCount, reportCount - 1);
+    blocked.store(false);
+
+    constexpr int32_t maxRetryCount = 1000;
+    for (int32_t i = 0; (i < maxRetryCount) && (listener->readCount_.load() == 0); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(listener->readCount_.load(), 1);
+    handler->RemoveFileDescriptorListener(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+}
+
+namespace {
+const uint32_t PICKED_EVENT_COUNT = 6;
+
+std::vector<uint32_t> DistributeWithPickBatchSize(uint32_t pickBatchSize)
+{
+    EventQueueBase queue(EventLockType::STANDARD);
+    queue.SetPickBatchSize(pickBatchSize);
+    queue.Prepare();
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    for (uint32_t i = 0; i < PICKED_EVENT_COUNT; ++i) {
+        auto highEvent = CreateIndexedEvent(handler, HAS_EVENT_ID + i, 0, 0);
+        queue.Insert(highEvent, EventQueue::Priority::HIGH);
+        auto lowEvent = CreateIndexedEvent(handler, REMOVE_EVENT_ID + i, 0, 0);
+        queue.Insert(lowEvent, EventQueue::Priority::LOW);
+    }
+    std::vector<uint32_t> eventIds;
+    eventIds.emplace_back(queue.GetEvent()->GetInnerEventId());
+    if (pickBatchSize > 1) {
+        EXPECT_EQ(queue.pickedEvents_.size(), pickBatchSize - 1);
+    }
+
+    // Picked events are still found, and removed events are never distributed.
+    EXPECT_TRUE(queue.HasInnerEvent(handler, HAS_EVENT_ID + 1));
+    queue.Remove(handler, HAS_EVENT_ID + 1);
+    EXPECT_FALSE(queue.HasInnerEvent(handler, HAS_EVENT_ID + 1));
+    eventIds.emplace_back(queue.GetEvent()->GetInnerEventId());
+
+    // Event of higher priority is distributed before picked events.
+    auto immediateEvent = CreateIndexedEvent(handler, HAS_EVENT_ID + PICKED_EVENT_COUNT, 0, 0);
+    queue.Insert(immediateEvent, EventQueue::Priority::IMMEDIATE);
+    for (uint32_t i = 2; i < PICKED_EVENT_COUNT + PICKED_EVENT_COUNT; ++i) {
+        eventIds.emplace_back(queue.GetEvent()->GetInnerEventId());
+    }
+    EXPECT_TRUE(queue.IsQueueEmpty());
+    return eventIds;
+}
+}  // unnamed namespace
+
+/*
+ * @tc.name: PickBatchTest_001
+ * @tc.desc: Events picked in batch are distributed in the same order as picked one by one,
+ *           even if some are removed or preempted after picked
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventQueueTest, PickBatchTest_001, TestSize.Level1)
+{
+    constexpr uint32_t pickBatchSize = 8;
+    auto expected = DistributeWithPickBatchSize(1);
+    EXPECT_EQ(expected[0], HAS_EVENT_ID);
+    EXPECT_EQ(expected[1], HAS_EVENT_ID + 2);
+    EXPECT_EQ(expected[2], HAS_EVENT_ID + PICKED_EVENT_COUNT);
+    EXPECT_EQ(DistributeWithPickBatchSize(pickBatchSize), expected);
+}
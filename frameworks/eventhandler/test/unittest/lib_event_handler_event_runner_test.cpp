@@ -15,12 +15,22 @@
 
 #include <atomic>
 #include <cerrno>
+#include <future>
 #include <thread>
+#include <vector>
 
+#include <pthread.h>
+#include <sched.h>
 #include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #include "event_handler.h"
+#include "event_handler_errors.h"
 #include "event_runner.h"
+#include "event_runner_group.h"
+#include "thread_info.h"
 
 #include <gtest/gtest.h>
 
@@ -344,6 +354,537 @@ HWTEST_F(LibEventHandlerEventRunnerTest, Current001, TestSize.Level1)
     runner->Run();
 }
 
+/*
+ * @tc.name: Current002
+ * @tc.desc: Current() returns the runner of each thread, and nullptr for threads without running runner
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, Current002, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(true);
+    auto otherRunner = EventRunner::Create(true);
+    std::atomic<bool> matched {false};
+    std::atomic<bool> otherMatched {false};
+    std::make_shared<EventHandler>(runner)->PostSyncTask([&runner, &matched]() { matched = (EventRunner::Current() == runner); });
+    std::make_shared<EventHandler>(otherRunner)->PostSyncTask([&otherRunner, &otherMatched]() {
+        otherMatched = (EventRunner::Current() == otherRunner);
+    });
+    EXPECT_TRUE(matched);
+    EXPECT_TRUE(otherMatched);
+
+    std::shared_ptr<EventRunner> threadRunner = runner;
+    std::thread thread([&threadRunner]() { threadRunner = EventRunner::Current(); });
+    thread.join();
+    EXPECT_EQ(nullptr, threadRunner);
+
+    auto localRunner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(localRunner);
+    handler->PostTask([&localRunner]() { localRunner->Stop(); });
+    localRunner->Run();
+    EXPECT_EQ(nullptr, EventRunner::Current());
+}
+
+/*
+ * @tc.name: ThreadInfo001
+ * @tc.desc: Thread info is cached for each thread
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, ThreadInfo001, TestSize.Level1)
+{
+    int64_t threadId = ThreadInfo::GetKernelThreadId();
+    EXPECT_EQ(threadId, static_cast<int64_t>(syscall(SYS_gettid)));
+    EXPECT_EQ(threadId, ThreadInfo::GetKernelThreadId());
+    EXPECT_EQ(ThreadInfo::IsAppMainThread(), EventRunner::IsAppMainThread());
+
+    int64_t otherThreadId = threadId;
+    bool isAppMainThread = true;
+    std::thread thread([&otherThreadId, &isAppMainThread]() {
+        otherThreadId = ThreadInfo::GetKernelThreadId();
+        isAppMainThread = ThreadInfo::IsAppMainThread();
+    });
+    thread.join();
+    EXPECT_NE(threadId, otherThreadId);
+    EXPECT_FALSE(isAppMainThread);
+}
+
+/*
+ * @tc.name: Stats001
+ * @tc.desc: Wakeups are issued only while the runner thread is sleeping, and elided while it is awake
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, Stats001, TestSize.Level1)
+{
+    const uint32_t taskCount = 8;
+    const int64_t sleepTime = 20;
+    auto runner = EventRunner::Create(std::string("Stats001"));
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+    EventRunnerStats stats = runner->GetStats();
+
+    // Runner thread is sleeping, so it has to be woken up.
+    std::atomic<uint32_t> count(0);
+    handler->PostTask([&handler, &count, taskCount]() {
+        // Runner thread is running this task, posting more tasks does not need to wake it up.
+        for (uint32_t i = 0; i < taskCount; ++i) {
+            handler->PostTask([&count]() { ++count; });
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime));
+    EXPECT_EQ(count.load(), taskCount);
+    EventRunnerStats newStats = runner->GetStats();
+    EXPECT_EQ(newStats.issuedWakeupCount, stats.issuedWakeupCount + 1);
+    EXPECT_EQ(newStats.elidedWakeupCount, stats.elidedWakeupCount + taskCount);
+    runner->Stop();
+}
+
+/*
+ * @tc.name: PoolMode001
+ * @tc.desc: Workers of pool distribute events of each handler one by one in order
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, PoolMode001, TestSize.Level1)
+{
+    constexpr uint32_t handlerCount = 4;
+    constexpr uint32_t taskCount = 200;
+    EventRunnerOptions options;
+    options.threadMode = ThreadMode::POOL;
+    options.poolSize = handlerCount;
+    auto runner = EventRunner::Create(std::string("PoolMode001"), options);
+    std::vector<std::shared_ptr<EventHandler>> handlers;
+    std::vector<std::vector<uint32_t>> orders(handlerCount);
+    std::vector<std::atomic<uint32_t>> running(handlerCount);
+    std::atomic<bool> overlapped(false);
+    std::atomic<uint32_t> doneCount(0);
+    for (uint32_t i = 0; i < handlerCount; ++i) {
+        handlers.emplace_back(std::make_shared<EventHandler>(runner));
+    }
+    for (uint32_t task = 0; task < taskCount; ++task) {
+        for (uint32_t i = 0; i < handlerCount; ++i) {
+            handlers[i]->PostTask([&, i, task]() {
+                if (running[i].fetch_add(1) != 0) {
+                    overlapped.store(true);
+                }
+                // Give other workers a chance to take the next event of this handler.
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                orders[i].emplace_back(task);
+                running[i].fetch_sub(1);
+                doneCount.fetch_add(1);
+            });
+        }
+    }
+
+    constexpr uint32_t maxRetryCount = 5000;
+    for (uint32_t count = 0; (count < maxRetryCount) && (doneCount.load() < handlerCount * taskCount); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_EQ(doneCount.load(), handlerCount * taskCount);
+    EXPECT_FALSE(overlapped.load());
+    for (uint32_t i = 0; i < handlerCount; ++i) {
+        ASSERT_EQ(orders[i].size(), taskCount);
+        for (uint32_t task = 0; task < taskCount; ++task) {
+            EXPECT_EQ(orders[i][task], task);
+        }
+    }
+}
+
+/*
+ * @tc.name: PoolMode002
+ * @tc.desc: Workers of pool distribute events of different handlers in parallel
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, PoolMode002, TestSize.Level1)
+{
+    EventRunnerOptions options;
+    options.threadMode = ThreadMode::POOL;
+    options.poolSize = 2;
+    auto runner = EventRunner::Create(std::string("PoolMode002"), options);
+    auto blockedHandler = std::make_shared<EventHandler>(runner);
+    auto otherHandler = std::make_shared<EventHandler>(runner);
+    std::atomic<bool> otherCalled(false);
+    std::atomic<bool> blockedDone(false);
+    std::atomic<bool> isRunnerThread(false);
+
+    // Only another worker could run the task of other handler, while this one is blocked.
+    blockedHandler->PostTask([&otherCalled, &blockedDone]() {
+        constexpr uint32_t maxRetryCount = 1000;
+        for (uint32_t count = 0; (count < maxRetryCount) && !otherCalled.load(); ++count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        blockedDone.store(true);
+    });
+    otherHandler->PostTask([&otherCalled, &isRunnerThread, &runner]() {
+        isRunnerThread.store(runner->IsCurrentRunnerThread());
+        otherCalled.store(true);
+    });
+
+    constexpr uint32_t maxRetryCount = 2000;
+    for (uint32_t count = 0; (count < maxRetryCount) && !blockedDone.load(); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(blockedDone.load());
+    EXPECT_TRUE(otherCalled.load());
+    EXPECT_TRUE(isRunnerThread.load());
+    EXPECT_FALSE(runner->IsCurrentRunnerThread());
+}
+
+/*
+ * @tc.name: PoolMode003
+ * @tc.desc: Sync events sent between handlers of pool never run in parallel with other events of their handler
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, PoolMode003, TestSize.Level1)
+{
+    constexpr uint32_t handlerCount = 2;
+    constexpr uint32_t taskCount = 50;
+    EventRunnerOptions options;
+    options.threadMode = ThreadMode::POOL;
+    options.poolSize = 4;
+    auto runner = EventRunner::Create(std::string("PoolMode003"), options);
+    std::vector<std::shared_ptr<EventHandler>> handlers;
+    std::vector<std::atomic<uint32_t>> running(handlerCount);
+    std::atomic<bool> overlapped(false);
+    for (uint32_t i = 0; i < handlerCount; ++i) {
+        handlers.emplace_back(std::make_shared<EventHandler>(runner));
+    }
+    auto work = [&running, &overlapped](uint32_t index) {
+        if (running[index].fetch_add(1) != 0) {
+            overlapped.store(true);
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(10));
+        running[index].fetch_sub(1);
+    };
+
+    // Handlers send to each other in turn, since two of them waiting for each other at the same time never return.
+    for (uint32_t sender = 0; sender < handlerCount; ++sender) {
+        uint32_t receiver = (sender + 1) % handlerCount;
+        std::atomic<uint32_t> doneCount(0);
+        for (uint32_t task = 0; task < taskCount; ++task) {
+            handlers[sender]->PostTask([&, sender, receiver]() {
+                work(sender);
+                handlers[receiver]->PostSyncTask([&work, receiver]() { work(receiver); });
+                doneCount.fetch_add(1);
+            });
+            handlers[receiver]->PostTask([&work, &doneCount, receiver]() {
+                work(receiver);
+                doneCount.fetch_add(1);
+            });
+        }
+        constexpr uint32_t maxRetryCount = 5000;
+        for (uint32_t count = 0; (count < maxRetryCount) && (doneCount.load() < taskCount * 2); ++count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(doneCount.load(), taskCount * 2);
+    }
+    EXPECT_FALSE(overlapped.load());
+}
+
+/*
+ * @tc.name: RunnerGroup001
+ * @tc.desc: Idle runner of group steals ready tasks from a busy peer, but leaves thread affine tasks
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, RunnerGroup001, TestSize.Level1)
+{
+    constexpr uint32_t taskCount = 10;
+    auto group = EventRunnerGroup::Create("RunnerGroup001", 2);
+    ASSERT_NE(group, nullptr);
+    EXPECT_EQ(group->GetRunnerCount(), 2);
+    auto busyHandler = std::make_shared<EventHandler>(group->GetRunner(0));
+    std::atomic<uint32_t> stolenCount(0);
+    std::atomic<bool> released(false);
+    std::atomic<bool> affineCalled(false);
+    std::atomic<bool> affineOnRunnerThread(false);
+    std::promise<bool> blocked;
+    auto blockedFuture = blocked.get_future();
+
+    // Blocker must stay on the busy runner, so it is thread affine and tasks are posted after it starts.
+    auto blockEvent = InnerEvent::Get([&released, &blocked, &group]() {
+        blocked.set_value(group->GetRunner(0)->IsCurrentRunnerThread());
+        constexpr uint32_t maxRetryCount = 2000;
+        for (uint32_t count = 0; (count < maxRetryCount) && !released.load(); ++count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+    blockEvent->MarkThreadAffine();
+    busyHandler->SendEvent(blockEvent);
+    EXPECT_TRUE(blockedFuture.get());
+    auto affineEvent = InnerEvent::Get([&affineCalled, &affineOnRunnerThread, &group]() {
+        affineOnRunnerThread.store(group->GetRunner(0)->IsCurrentRunnerThread());
+        affineCalled.store(true);
+    });
+    affineEvent->MarkThreadAffine();
+    busyHandler->SendEvent(affineEvent);
+    for (uint32_t i = 0; i < taskCount; ++i) {
+        busyHandler->PostTask([&stolenCount, &group]() {
+            if (group->GetRunner(1)->IsCurrentRunnerThread()) {
+                stolenCount.fetch_add(1);
+            }
+        });
+    }
+
+    // All tasks except the affine one are taken by the idle runner, while the busy one is blocked.
+    constexpr uint32_t maxRetryCount = 1000;
+    for (uint32_t count = 0; (count < maxRetryCount) && (stolenCount.load() < taskCount); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_EQ(stolenCount.load(), taskCount);
+    EXPECT_FALSE(affineCalled.load());
+    auto stats = group->GetStats();
+    ASSERT_EQ(stats.size(), 2);
+    EXPECT_EQ(stats[0].lostCount, taskCount);
+    EXPECT_EQ(stats[1].stolenCount, taskCount);
+    EXPECT_EQ(stats[0].queueDepth, 1);
+
+    released.store(true);
+    for (uint32_t count = 0; (count < maxRetryCount) && !affineCalled.load(); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(affineCalled.load());
+    EXPECT_TRUE(affineOnRunnerThread.load());
+}
+
+/*
+ * @tc.name: RunnerGroup002
+ * @tc.desc: Check creation and sharding of runner group
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, RunnerGroup002, TestSize.Level1)
+{
+    EXPECT_EQ(EventRunnerGroup::Create("RunnerGroup002", 0), nullptr);
+    EventRunnerOptions options;
+    options.threadMode = ThreadMode::POOL;
+    EXPECT_EQ(EventRunnerGroup::Create("RunnerGroup002", 2, options), nullptr);
+
+    constexpr uint32_t runnerCount = 3;
+    auto group = EventRunnerGroup::Create("RunnerGroup002", runnerCount);
+    ASSERT_NE(group, nullptr);
+    EXPECT_EQ(group->GetRunner(runnerCount), nullptr);
+    EXPECT_EQ(group->GetRunnerByKey(runnerCount + 1), group->GetRunner(1));
+    EXPECT_NE(group->GetRunner(0), group->GetRunner(1));
+    for (const auto &stats : group->GetStats()) {
+        EXPECT_EQ(stats.stolenCount, 0);
+        EXPECT_EQ(stats.lostCount, 0);
+        EXPECT_EQ(stats.queueDepth, 0);
+    }
+}
+
+/*
+ * @tc.name: ThreadAttributes001
+ * @tc.desc: Runner thread applies cpu set, scheduling policy, nice value and stack size of options
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, ThreadAttributes001, TestSize.Level1)
+{
+    constexpr int32_t niceValue = 5;
+    // Larger than the default stack size, which is usually 8M.
+    constexpr size_t stackSize = 16 * 1024 * 1024;
+    EventRunnerOptions options;
+    options.threadAttributes.cpuSet = {0};
+    options.threadAttributes.schedPolicy = ThreadSchedPolicy::BATCH;
+    options.threadAttributes.niceValue = niceValue;
+    options.threadAttributes.stackSize = stackSize;
+    auto runner = EventRunner::Create(std::string("ThreadAttributes001"), options);
+    ASSERT_NE(runner, nullptr);
+    EXPECT_EQ(runner->GetThreadAttributesResult(), ERR_OK);
+
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::atomic<bool> taskCalled(false);
+    int policy = -1;
+    int nice = 0;
+    bool pinned = false;
+    size_t actualStackSize = 0;
+    auto f = [&]() {
+        policy = sched_getscheduler(0);
+        errno = 0;
+        nice = getpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)));
+        cpu_set_t cpuSet;
+        CPU_ZERO(&cpuSet);
+        pinned = (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) && (CPU_COUNT(&cpuSet) == 1) &&
+            CPU_ISSET(0, &cpuSet);
+        pthread_attr_t attr;
+        if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+            (void)pthread_attr_getstacksize(&attr, &actualStackSize);
+            (void)pthread_attr_destroy(&attr);
+        }
+        taskCalled.store(true);
+    };
+    ASSERT_TRUE(handler->PostTask(f));
+    constexpr uint32_t maxRetryCount = 1000;
+    for (uint32_t count = 0; (count < maxRetryCount) && !taskCalled.load(); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    ASSERT_TRUE(taskCalled.load());
+    EXPECT_EQ(policy, SCHED_BATCH);
+    EXPECT_EQ(nice, niceValue);
+    EXPECT_TRUE(pinned);
+    EXPECT_GE(actualStackSize, stackSize);
+}
+
+/*
+ * @tc.name: ThreadAttributes002
+ * @tc.desc: Invalid thread attributes are reported, and the runner still works
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, ThreadAttributes002, TestSize.Level1)
+{
+    constexpr int32_t invalidNiceValue = 100;
+    EventRunnerOptions options;
+    options.threadAttributes.niceValue = invalidNiceValue;
+    auto runner = EventRunner::Create(std::string("ThreadAttributes002"), options);
+    ASSERT_NE(runner, nullptr);
+    EXPECT_EQ(runner->GetThreadAttributesResult(), EVENT_HANDLER_ERR_INVALID_PARAM);
+
+    EventRunnerOptions poolOptions;
+    poolOptions.threadMode = ThreadMode::POOL;
+    poolOptions.poolSize = 2;
+    poolOptions.threadAttributes.cpuSet = {CPU_SETSIZE};
+    auto pool = EventRunner::Create(std::string("ThreadAttributes002"), poolOptions);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool->GetThreadAttributesResult(), EVENT_HANDLER_ERR_INVALID_PARAM);
+    EXPECT_EQ(EventRunner::Create(false)->GetThreadAttributesResult(), ERR_OK);
+
+    auto handler = std::make_shared<EventHandler>(pool);
+    std::atomic<bool> taskCalled(false);
+    ASSERT_TRUE(handler->PostTask([&taskCalled]() { taskCalled.store(true); }));
+    constexpr uint32_t maxRetryCount = 1000;
+    for (uint32_t count = 0; (count < maxRetryCount) && !taskCalled.load(); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(taskCalled.load());
+}
+
+/*
+ * @tc.name: ThreadAttributes003
+ * @tc.desc: Invalid stack size is reported when runner is created, and the default stack size of process is kept
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, ThreadAttributes003, TestSize.Level1)
+{
+    size_t defaultStackSize = 0;
+    pthread_attr_t attr;
+    ASSERT_EQ(pthread_getattr_default_np(&attr), 0);
+    (void)pthread_attr_getstacksize(&attr, &defaultStackSize);
+    (void)pthread_attr_destroy(&attr);
+
+    // Smaller than the minimum stack size.
+    constexpr size_t invalidStackSize = 1;
+    EventRunnerOptions options;
+    options.threadAttributes.stackSize = invalidStackSize;
+    auto runner = EventRunner::Create(std::string("ThreadAttributes003"), options);
+    ASSERT_NE(runner, nullptr);
+    EXPECT_EQ(runner->GetThreadAttributesResult(), EVENT_HANDLER_ERR_INVALID_PARAM);
+
+    EventRunnerOptions poolOptions;
+    poolOptions.threadMode = ThreadMode::POOL;
+    poolOptions.poolSize = 2;
+    poolOptions.threadAttributes.stackSize = 4 * 1024 * 1024;
+    auto pool = EventRunner::Create(std::string("ThreadAttributes003"), poolOptions);
+    ASSERT_NE(pool, nullptr);
+    EXPECT_EQ(pool->GetThreadAttributesResult(), ERR_OK);
+
+    size_t stackSize = 0;
+    ASSERT_EQ(pthread_getattr_default_np(&attr), 0);
+    (void)pthread_attr_getstacksize(&attr, &stackSize);
+    (void)pthread_attr_destroy(&attr);
+    EXPECT_EQ(stackSize, defaultStackSize);
+
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::atomic<bool> taskCalled(false);
+    ASSERT_TRUE(handler->PostTask([&taskCalled]() { taskCalled.store(true); }));
+    constexpr uint32_t maxRetryCount = 1000;
+    for (uint32_t count = 0; (count < maxRetryCount) && !taskCalled.load(); ++count) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    EXPECT_TRUE(taskCalled.load());
+}
+
+/*
+ * @tc.name: BusyPoll001
+ * @tc.desc: Runner takes events posted while busy polling without being woken up, and sleeps after polling in vain
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, BusyPoll001, TestSize.Level1)
+{
+    constexpr uint32_t busyPollTime = 200000;
+    constexpr int64_t idleTime = 300;
+    EventRunnerOptions options;
+    options.busyPollMicroseconds = busyPollTime;
+    auto runner = EventRunner::Create(std::string("BusyPoll001"), options);
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::this_thread::sleep_for(std::chrono::milliseconds(idleTime));
+    EXPECT_GE(runner->GetStats().busyPollParkCount, 1);
+
+    auto waitTask = [&handler](uint32_t &count) {
+        std::atomic<bool> taskCalled(false);
+        ASSERT_TRUE(handler->PostTask([&taskCalled]() { taskCalled.store(true); }));
+        constexpr uint32_t maxRetryCount = 1000;
+        for (count = 0; (count < maxRetryCount) && !taskCalled.load(); ++count) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        EXPECT_TRUE(taskCalled.load());
+    };
+    uint32_t retryCount = 0;
+    waitTask(retryCount);
+    // Runner is polling after the task, so the next one needs no wakeup.
+    EventRunnerStats stats = runner->GetStats();
+    waitTask(retryCount);
+    EventRunnerStats newStats = runner->GetStats();
+    EXPECT_EQ(newStats.issuedWakeupCount, stats.issuedWakeupCount);
+    EXPECT_GT(newStats.busyPollHitCount, stats.busyPollHitCount);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(idleTime));
+    EXPECT_GT(runner->GetStats().busyPollParkCount, newStats.busyPollParkCount);
+    runner->Stop();
+
+    auto defaultRunner = EventRunner::Create(std::string("BusyPoll001"));
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_EQ(defaultRunner->GetStats().busyPollHitCount, 0);
+    EXPECT_EQ(defaultRunner->GetStats().busyPollParkCount, 0);
+}
+
+/*
+ * @tc.name: PickBatch001
+ * @tc.desc: Tasks picked in a batch run in order, and could be removed by tasks before them
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerEventRunnerTest, PickBatch001, TestSize.Level1)
+{
+    constexpr uint32_t taskCount = 32;
+    EventRunnerOptions options;
+    options.pickBatchSize = taskCount;
+    auto runner = EventRunner::Create(std::string("PickBatch001"), options);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    // Hold the runner, so that the following tasks are picked together.
+    std::promise<void> started;
+    std::promise<void> released;
+    auto releasedFuture = released.get_future().share();
+    handler->PostTask([&started, releasedFuture]() {
+        started.set_value();
+        releasedFuture.wait();
+    });
+    started.get_future().wait();
+
+    std::vector<uint32_t> order;
+    std::atomic<bool> victimCalled(false);
+    handler->PostTask([&handler]() { handler->RemoveTask("victim"); });
+    handler->PostTask([&victimCalled]() { victimCalled.store(true); }, "victim");
+    for (uint32_t i = 0; i < taskCount; ++i) {
+        handler->PostTask([&order, i]() { order.emplace_back(i); });
+    }
+    std::promise<void> finished;
+    handler->PostTask([&finished]() { finished.set_value(); });
+    released.set_value();
+    finished.get_future().wait();
+
+    EXPECT_FALSE(victimCalled.load());
+    ASSERT_EQ(order.size(), taskCount);
+    for (uint32_t i = 0; i < taskCount; ++i) {
+        EXPECT_EQ(order[i], i);
+    }
+    runner->Stop();
+}
+
 /*
  * @tc.name: SetLogger001
  * @tc.desc: check SetLogger001 success
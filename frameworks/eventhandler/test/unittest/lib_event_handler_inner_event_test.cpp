@@ -14,6 +14,9 @@
  */
 
 #include <gtest/gtest.h>
+#include <thread>
+#include <vector>
+
 #include "inner_event.h"
 
 using namespace testing::ext;
@@ -89,3 +92,103 @@ HWTEST_F(LibEventHandlerInnerEventTest, GetEventPointer001, TestSize.Level1)
     // drop event, execute destructor function
     EXPECT_TRUE(callbackCalled);
 }
+
+/*
+ * @tc.name: EventPool001
+ * @tc.desc: Recycled event is taken from pool and all of its states are reset
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerInnerEventTest, EventPool001, TestSize.Level1)
+{
+    uint32_t eventId = 1;
+    int64_t eventParam = 1;
+    auto event = InnerEvent::Get(eventId, eventParam);
+    ASSERT_NE(nullptr, event);
+    event->SetOwnerId("1_owner");
+    event->SetEventPriority(1);
+    event->SetDelayTime(1);
+    event->MarkVsyncTask();
+    event->MarkBarrierTask();
+    event->SetIsEnhanced(true);
+    event->SetEmitterId(1);
+    event.reset();
+
+    auto before = InnerEvent::GetPoolStats();
+    EXPECT_GT(before.pooledCount, 0);
+    event = InnerEvent::Get();
+    auto after = InnerEvent::GetPoolStats();
+    ASSERT_NE(nullptr, event);
+    EXPECT_EQ(before.hitCount + 1, after.hitCount);
+    EXPECT_EQ(before.missCount, after.missCount);
+    EXPECT_EQ(0u, event->GetInnerEventId());
+    EXPECT_EQ(0, event->GetParam());
+    EXPECT_EQ(0u, event->GetOwnerNumericId());
+    EXPECT_TRUE(event->GetOwnerId().empty());
+    EXPECT_EQ(-1, event->GetEventPriority());
+    EXPECT_EQ(0, event->GetDelayTime());
+    EXPECT_FALSE(event->IsVsyncTask());
+    EXPECT_FALSE(event->IsBarrierTask());
+    EXPECT_FALSE(event->IsEnhanced());
+    EXPECT_EQ(0u, event->GetEmitterId());
+    EXPECT_FALSE(event->HasTask());
+}
+
+/*
+ * @tc.name: EventPool002
+ * @tc.desc: Events dropped on other threads are kept by pool, and high-water counter is updated
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerInnerEventTest, EventPool002, TestSize.Level1)
+{
+    const size_t threadCount = 4;
+    const size_t eventCount = 256;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([eventCount]() {
+            std::vector<InnerEvent::Pointer> events;
+            for (size_t j = 0; j < eventCount; ++j) {
+                events.emplace_back(InnerEvent::Get(j, 0));
+            }
+            events.clear();
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    auto stats = InnerEvent::GetPoolStats();
+    EXPECT_GT(stats.highWaterCount, 0);
+    EXPECT_GE(stats.highWaterCount, stats.pooledCount);
+    EXPECT_GT(stats.hitCount + stats.missCount, threadCount * eventCount - 1);
+}
+
+/*
+ * @tc.name: Caller001
+ * @tc.desc: Caller keeps string literals directly, interns other strings, and is formatted on demand
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerInnerEventTest, Caller001, TestSize.Level1)
+{
+    const char *file = "/path/to/caller.cpp";
+    const char *func = "Func";
+    Caller literalCaller(file, 1, func);
+    EXPECT_EQ(file, literalCaller.file_);
+    EXPECT_EQ(func, literalCaller.func_);
+    EXPECT_EQ("[caller.cpp(Func:1)]", literalCaller.ToString());
+
+    std::string dynamicFile = std::string("/path/to/") + "caller.cpp";
+    Caller stringCaller(dynamicFile, 1, std::string(func));
+    Caller otherStringCaller(dynamicFile, 1, std::string(func));
+    dynamicFile.clear();
+    EXPECT_EQ(stringCaller.file_, otherStringCaller.file_);
+    EXPECT_EQ(stringCaller.func_, otherStringCaller.func_);
+    EXPECT_EQ("[caller.cpp(Func:1)]", stringCaller.ToString());
+
+    stringCaller.SetDfxName("_dfx");
+    EXPECT_EQ("[caller.cpp(Func:1_dfx)]", stringCaller.ToString());
+    auto event = InnerEvent::Get(0, 0, stringCaller);
+    EXPECT_EQ("[caller.cpp(Func:1_dfx)]", event->GetCaller().ToString());
+
+    stringCaller.ClearCaller();
+    EXPECT_EQ("[ ]", stringCaller.ToString());
+}
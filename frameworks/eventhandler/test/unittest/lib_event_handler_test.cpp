@@ -28,7 +28,9 @@
 #include <unistd.h>
 #include "async_stack_adapter.h"
 #include "local_handle_adapter.h"
+#include "adaptive_lock.h"
 #include "lock_base.h"
+#include "queue_lock_guard.h"
 #include "std_lock.h"
 
 using namespace testing::ext;
@@ -577,4 +579,217 @@ HWTEST_F(LibEventHandlerTest, LockTest_001, TestSize.Level1)
     lockBase1.unlock();
     auto handler = std::make_shared<EventHandler>(nullptr);
     EXPECT_NE(nullptr, handler);
-}
\ No newline at end of file
+}
+
+namespace {
+template<typename Lock>
+void CheckMutualExclusion(EventLockType type)
+{
+    constexpr uint32_t threadNum = 4;
+    constexpr uint32_t loopNum = 20000;
+    Lock lock;
+    uint32_t count = 0;
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < threadNum; ++i) {
+        threads.emplace_back([&lock, &count, type, i]() {
+            for (uint32_t j = 0; j < loopNum; ++j) {
+                if ((i % 2) == 0) {
+                    QueueLockGuard guard(type, lock);
+                    ++count;
+                } else {
+                    UniqueLockBase guard(lock);
+                    ++count;
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_EQ(count, threadNum * loopNum);
+}
+}  // unnamed namespace
+
+/*
+ * @tc.name: LockTest_002
+ * @tc.desc: Adaptive locks exclude each other, whether locked through typed guard or virtual functions
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, LockTest_002, TestSize.Level1)
+{
+    CheckMutualExclusion<StdLock>(EventLockType::STANDARD);
+    CheckMutualExclusion<AdaptiveLock>(EventLockType::ADAPTIVE);
+    CheckMutualExclusion<AdaptivePriorityInheritanceLock>(EventLockType::ADAPTIVE_PRIORITY_INHERIT);
+}
+
+/*
+ * @tc.name: LockTest_003
+ * @tc.desc: Event runners created with adaptive locks run posted tasks
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, LockTest_003, TestSize.Level1)
+{
+    for (auto type : {EventLockType::ADAPTIVE, EventLockType::ADAPTIVE_PRIORITY_INHERIT}) {
+        auto runner = EventRunner::Create(false, ThreadMode::NEW_THREAD, type);
+        ASSERT_NE(nullptr, runner);
+        auto handler = std::make_shared<EventHandler>(runner);
+        bool ran = false;
+        handler->PostTask([&ran]() { ran = true; });
+        handler->PostTask([runner]() { runner->Stop(); });
+        runner->Run();
+        EXPECT_TRUE(ran);
+    }
+}
+/*
+ * @tc.name: HandlerId_001
+ * @tc.desc: Each handler has a unique numeric id, events are tagged with it and removed with the handler
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, HandlerId_001, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto otherHandler = std::make_shared<EventHandler>(runner);
+    EXPECT_NE(0u, handler->GetHandlerNumericId());
+    EXPECT_NE(handler->GetHandlerNumericId(), otherHandler->GetHandlerNumericId());
+    EXPECT_EQ(0u, handler->GetHandlerId().find(std::to_string(handler->GetHandlerNumericId()) + "_"));
+
+    uint32_t eventId = 1;
+    handler->SendEvent(eventId, 0, 1000);
+    otherHandler->SendEvent(eventId, 0, 1000);
+    EXPECT_TRUE(handler->HasInnerEvent(eventId));
+    EXPECT_TRUE(otherHandler->HasInnerEvent(eventId));
+
+    // Events of a handler are removed by its numeric id while it is destroyed.
+    handler.reset();
+    EXPECT_TRUE(otherHandler->HasInnerEvent(eventId));
+    otherHandler->RemoveEvent(eventId);
+    EXPECT_FALSE(otherHandler->HasInnerEvent(eventId));
+    EXPECT_TRUE(runner->GetEventQueue()->IsQueueEmpty());
+}
+
+/*
+ * @tc.name: OwnerId_001
+ * @tc.desc: String owner id of events is kept along with the numeric one
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, OwnerId_001, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    uint32_t eventId = 1;
+    EXPECT_TRUE(handler->SendEvent(eventId));
+    InnerEvent::TimePoint nextExpiredTime;
+    auto event = runner->GetEventQueue()->GetExpiredEvent(nextExpiredTime);
+    ASSERT_NE(nullptr, event);
+    EXPECT_EQ(handler->GetHandlerNumericId(), event->GetOwnerNumericId());
+    EXPECT_EQ(handler->GetHandlerId(), event->GetOwnerId());
+
+    event = InnerEvent::Get(eventId);
+    EXPECT_TRUE(event->GetOwnerId().empty());
+    event->SetOwnerId(handler->GetHandlerId());
+    EXPECT_EQ(handler->GetHandlerNumericId(), event->GetOwnerNumericId());
+    EXPECT_EQ(handler->GetHandlerId(), event->GetOwnerId());
+    event->SetOwnerId("owner");
+    EXPECT_EQ(0u, event->GetOwnerNumericId());
+    EXPECT_EQ("owner", event->GetOwnerId());
+}
+
+/*
+ * @tc.name: PostMoveOnlyTask_001
+ * @tc.desc: Post move-only tasks, small tasks are stored in place, and tasks removed before running are released
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, PostMoveOnlyTask_001, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    auto value = std::make_unique<int>(1);
+    int result = 0;
+    auto task = [value = std::move(value), &result]() { result = *value; };
+    EXPECT_TRUE(TaskCallable(std::move(task)).IsInline());
+    EXPECT_FALSE(TaskCallable(InnerEvent::Callback()));
+    EXPECT_FALSE(handler->PostTask(TaskCallable()));
+
+    EXPECT_TRUE(handler->PostTask([value = std::make_unique<int>(2), &result]() { result = *value; }));
+    handler->PostTask([runner]() { runner->Stop(); });
+    runner->Run();
+    EXPECT_EQ(2, result);
+
+    auto released = std::make_shared<int>(0);
+    std::weak_ptr<int> weak = released;
+    EXPECT_TRUE(handler->PostTask([released = std::move(released)]() {}, "moveOnly", 1000));
+    EXPECT_FALSE(weak.expired());
+    handler->RemoveTask("moveOnly");
+    EXPECT_TRUE(weak.expired());
+}
+
+/*
+ * @tc.name: PostMoveOnlyTask_002
+ * @tc.desc: Get task callback of events posted through the callable overloads
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, PostMoveOnlyTask_002, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    int result = 0;
+    EXPECT_TRUE(handler->PostTask([value = std::make_unique<int>(1), &result]() { result += *value; }));
+    InnerEvent::TimePoint nextExpiredTime;
+    auto event = runner->GetEventQueue()->GetExpiredEvent(nextExpiredTime);
+    ASSERT_NE(nullptr, event);
+    ASSERT_TRUE(event->HasTask());
+    const InnerEvent::Callback &callback = event->GetTaskCallback();
+    ASSERT_TRUE(callback);
+    callback();
+    EXPECT_EQ(1, result);
+    EXPECT_TRUE(event->GetTask());
+    event->RunTask();
+    EXPECT_EQ(2, result);
+
+    auto released = std::make_shared<int>(0);
+    std::weak_ptr<int> weak = released;
+    event = InnerEvent::Get(TaskCallable([released = std::move(released)]() {}));
+    EXPECT_TRUE(event->GetTaskCallback());
+    EXPECT_FALSE(weak.expired());
+    event.reset();
+    EXPECT_TRUE(weak.expired());
+}
+
+/*
+ * @tc.name: PostTasks_001
+ * @tc.desc: Post and send events in batches, they are handled in order of priority and handle time
+ * @tc.type: FUNC
+ */
+HWTEST_F(LibEventHandlerTest, PostTasks_001, TestSize.Level1)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::vector<int> order;
+
+    std::vector<TaskSpec> tasks;
+    tasks.emplace_back([&order]() { order.push_back(1); });
+    tasks.emplace_back([&order]() { order.push_back(2); });
+    tasks.emplace_back([&order]() { order.push_back(0); }, "high", 0, EventQueue::Priority::HIGH);
+    tasks.emplace_back([&order]() { order.push_back(3); }, "delayed", 1);
+    tasks.emplace_back([runner]() { runner->Stop(); }, "stop", 10);
+    EXPECT_TRUE(handler->PostTasks(tasks));
+    runner->Run();
+    EXPECT_EQ((std::vector<int> {0, 1, 2, 3}), order);
+
+    uint32_t eventId = 1;
+    std::vector<InnerEvent::Pointer> events;
+    events.emplace_back(InnerEvent::Get(eventId));
+    events.emplace_back(InnerEvent::Get(eventId + 1));
+    EXPECT_TRUE(handler->SendEvents(events, 1000));
+    EXPECT_TRUE(handler->HasInnerEvent(eventId));
+    EXPECT_TRUE(handler->HasInnerEvent(eventId + 1));
+    handler->RemoveAllEvents();
+
+    events.clear();
+    events.emplace_back(InnerEvent::Pointer(nullptr, nullptr));
+    EXPECT_FALSE(handler->SendEvents(events));
+}
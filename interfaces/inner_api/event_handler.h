@@ -53,6 +53,27 @@ struct TaskOptions {
 struct PendingTaskInfo {
     int32_t MaxPendingTime = 0;
     int32_t taskCount = 0;
+    // Count of events merged into a pending call, for listeners with FILE_DESCRIPTOR_COALESCED.
+    int32_t coalescedCount = 0;
+};
+
+/*
+ * Task posted in a batch by EventHandler::PostTasks.
+ */
+struct TaskSpec {
+    TaskCallable task;
+    std::string name;
+    int64_t delayTime = 0;
+    EventQueue::Priority priority = EventQueue::Priority::LOW;
+    Caller caller;
+    // Never stolen by peers of the runner in 'EventRunnerGroup'.
+    bool threadAffine = false;
+
+    template<typename F, typename = std::enable_if_t<std::is_constructible_v<TaskCallable, F>>>
+    explicit TaskSpec(F &&callable, const std::string &taskName = std::string(), int64_t delay = 0,
+        EventQueue::Priority taskPriority = EventQueue::Priority::LOW, const Caller &taskCaller = {})
+        : task(std::forward<F>(callable)), name(taskName), delayTime(delay), priority(taskPriority),
+          caller(taskCaller) {}
 };
 class EventHandler : public std::enable_shared_from_this<EventHandler> {
 public:
@@ -86,6 +107,17 @@ public:
      */
     bool SendEvent(InnerEvent::Pointer &event, int64_t delayTime = 0, Priority priority = Priority::LOW);
 
+    /**
+     * Send a batch of events, they are inserted into event queue together, with the lock of queue held only once.
+     *
+     * @param events Events which should be handled, sent events are moved out.
+     * @param delayTime Process the events after 'delayTime' milliseconds.
+     * @param priority Priority of the event queue for these events.
+     * @return Returns true if all events have been sent successfully. Events left should be released manually.
+     */
+    bool SendEvents(std::vector<InnerEvent::Pointer> &events, int64_t delayTime = 0,
+        Priority priority = Priority::LOW);
+
     /**
      * Send an event.
      *
@@ -442,6 +474,65 @@ public:
         return SendEvent(InnerEvent::Get(callback, name, caller), delayTime, priority);
     }
 
+    /**
+     * Post a task, the task is stored in the event without extra allocation if small enough.
+     *
+     * @param task Move-only task callable.
+     * @param name Name of the task.
+     * @param delayTime Process the event after 'delayTime' milliseconds.
+     * @param priority Priority of the event queue for this event.
+     * @param caller Caller info of the event, default is caller's file, func and line.
+     * @return Returns true if task has been sent successfully.
+     */
+    inline bool PostTask(TaskCallable &&task, const std::string &name = std::string(),
+                         int64_t delayTime = 0, Priority priority = Priority::LOW, const Caller &caller = {})
+    {
+        return SendEvent(InnerEvent::Get(std::move(task), name, caller), delayTime, priority);
+    }
+
+    /**
+     * Post a task with a callable object, such as a lambda, instead of wrapping it in a std::function.
+     *
+     * @param task Task callable, it could be move-only.
+     * @param name Name of the task.
+     * @param delayTime Process the event after 'delayTime' milliseconds.
+     * @param priority Priority of the event queue for this event.
+     * @param caller Caller info of the event, default is caller's file, func and line.
+     * @return Returns true if task has been sent successfully.
+     */
+    template<typename F, typename Fn = std::decay_t<F>,
+        typename = std::enable_if_t<!std::is_same_v<Fn, Callback> && !std::is_same_v<Fn, TaskCallable> &&
+            std::is_invocable_v<Fn &>>>
+    inline bool PostTask(F &&task, const std::string &name = std::string(),
+                         int64_t delayTime = 0, Priority priority = Priority::LOW, const Caller &caller = {})
+    {
+        return PostTask(TaskCallable(std::forward<F>(task)), name, delayTime, priority, caller);
+    }
+
+    template<typename F, typename Fn = std::decay_t<F>,
+        typename = std::enable_if_t<!std::is_same_v<Fn, Callback> && !std::is_same_v<Fn, TaskCallable> &&
+            std::is_invocable_v<Fn &>>>
+    inline bool PostTask(F &&task, int64_t delayTime, Priority priority = Priority::LOW, const Caller &caller = {})
+    {
+        return PostTask(TaskCallable(std::forward<F>(task)), std::string(), delayTime, priority, caller);
+    }
+
+    template<typename F, typename Fn = std::decay_t<F>,
+        typename = std::enable_if_t<!std::is_same_v<Fn, Callback> && !std::is_same_v<Fn, TaskCallable> &&
+            std::is_invocable_v<Fn &>>>
+    inline bool PostTask(F &&task, Priority priority, const Caller &caller = {})
+    {
+        return PostTask(TaskCallable(std::forward<F>(task)), std::string(), 0, priority, caller);
+    }
+
+    /**
+     * Post a batch of tasks, they are inserted into event queue together, with the lock of queue held only once.
+     *
+     * @param tasks Tasks which should be posted, all tasks are moved out.
+     * @return Returns true if all tasks have been posted successfully.
+     */
+    bool PostTasks(std::vector<TaskSpec> &tasks);
+
     /**
      * Post a task at front of queue.
      *
@@ -1124,6 +1215,11 @@ public:
         return handlerId_;
     }
 
+    /**
+     * Get numeric handler id, which is unique in process and used to tag events, only for inner use
+     */
+    uint64_t GetHandlerNumericId() const;
+
     /**
      * Get pending task info
      */
@@ -1231,7 +1327,11 @@ private:
      */
     InnerEvent::Pointer CreateTask(const Callback &callback, const std::string &name,
         Priority priority, const Caller &caller);
+
+    // Fill in send time, handle time, owner and async stack of an event before inserting it.
+    void PrepareEvent(InnerEvent::Pointer &event, const InnerEvent::TimePoint &now, int64_t delayTime);
     
+    // Handler id in form of "<numeric id>_<creation time>", the numeric id is taken from it to tag events.
     std::string handlerId_;
     bool enableEventLog_ {false};
     std::shared_ptr<EventRunner> eventRunner_;
@@ -22,6 +22,7 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <vector>
 
 #include "inner_event.h"
 #include "event_handler_errors.h"
@@ -333,6 +334,13 @@ public:
      */
     void CheckFileDescriptorEvent();
 
+    /**
+     * Listen the file descriptor again, after its one-shot events have been handled.
+     *
+     * @param fileDescriptor File descriptor which is listened with {@link FILE_DESCRIPTOR_ONESHOT}.
+     */
+    void RearmFileDescriptorListener(int32_t fileDescriptor);
+
     /**
      * Set waiter mode, true for deamon io waiter
      */
@@ -395,6 +403,20 @@ public:
      */
     virtual uint64_t GetQueueFirstEventHandleTime(uint64_t now, int32_t priority, bool onlyCheckVsync = true) = 0;
 
+    /**
+     * Insert a batch of events at end of event queue, with the priority set in each event.
+     * Base queue inserts the whole batch with the lock held only once, and wakes up the runner at most once.
+     *
+     * @param events Events which should be added into event queue, inserted events are moved out.
+     * @return Returns true if all events are inserted.
+     */
+    virtual bool InsertBatch(std::vector<InnerEvent::Pointer> &events);
+
+    /**
+     * Remove events of a finishing handler by its numeric id, for base queue.
+     */
+    virtual void RemoveOrphanByOwnerId(uint64_t ownerId) { (void)ownerId; };
+
     /**
      * Set the first force enable time for AppVsync.
      * @enable Enable or not
@@ -516,6 +538,78 @@ protected:
     void HandleFileDescriptorEvent(int32_t fileDescriptor, uint32_t events, const std::string &name,
         Priority priority);
 
+    /**
+     * Handle file descriptor event, whose listener is already known by IO waiter.
+     *
+     * @param fileDescriptor File descriptor.
+     * @param events Events from file descriptor, such as input, output, error
+     * @param name task name.
+     * @param Priority Priority of the event.
+     * @param listener Listener of the file descriptor.
+     */
+    void DispatchFileDescriptorEvent(int32_t fileDescriptor, uint32_t events, const std::string &name,
+        Priority priority, const std::shared_ptr<FileDescriptorListener> &listener);
+
+    /**
+     * Keep file descriptor event to call its listener from the running loop directly, instead of posting a task.
+     *
+     * @param fileDescriptor File descriptor.
+     * @param events Events from file descriptor, with {@link FILE_DESCRIPTOR_DIRECT_DISPATCH}.
+     * @param Priority Priority of the listener, relative to queued events.
+     * @param listener Listener of the file descriptor.
+     * @return Return false if not supported, a task should be posted then.
+     */
+    virtual bool PushDirectFileDescriptorEvent(int32_t fileDescriptor, uint32_t events, Priority priority,
+        const std::shared_ptr<FileDescriptorListener> &listener)
+    {
+        return false;
+    }
+
+    /**
+     * Call listener for events from file descriptor.
+     *
+     * @param listener Listener of the file descriptor.
+     * @param fileDescriptor File descriptor.
+     * @param events Events from file descriptor, such as input, output, error
+     */
+    static void NotifyFileDescriptorListener(const std::shared_ptr<FileDescriptorListener> &listener,
+        int32_t fileDescriptor, uint32_t events);
+
+    /**
+     * Merge events into the pending call of a listener with {@link FILE_DESCRIPTOR_COALESCED}.
+     *
+     * @param fileDescriptor File descriptor.
+     * @param events Events from file descriptor.
+     * @return Return true if merged, otherwise a call of the listener should be pending now.
+     * Queue which does not support merging always returns false.
+     */
+    virtual bool CoalesceFileDescriptorEvent(int32_t fileDescriptor, uint32_t events)
+    {
+        return false;
+    }
+
+    /**
+     * Take events merged into the pending call of a listener, before calling it.
+     *
+     * @param fileDescriptor File descriptor.
+     * @param events Events reported while the call became pending.
+     * @return Return all events to handle by the call.
+     */
+    virtual uint32_t TakeCoalescedFileDescriptorEvents(int32_t fileDescriptor, uint32_t events)
+    {
+        return events;
+    }
+
+    /**
+     * Check whether several worker threads take events from this queue.
+     *
+     * @return Return true if events are taken by worker pool.
+     */
+    virtual bool IsWorkerPool() const
+    {
+        return false;
+    }
+
     /**
      * remove listener by owner.
      *
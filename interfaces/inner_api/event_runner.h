@@ -17,6 +17,8 @@
 #define BASE_EVENTHANDLER_INTERFACES_INNER_API_EVENT_RUNNER_H
 
 #include <atomic>
+#include <climits>
+#include <vector>
 
 #include "event_queue.h"
 #include "dumper.h"
@@ -37,6 +39,74 @@ enum class Mode: uint32_t {
 enum class ThreadMode: uint32_t {
     NEW_THREAD = 0,    // for new thread mode, event handler create thread
     FFRT,           // for new thread mode, use ffrt
+    POOL,           // for new thread mode, several threads take events from the same queue
+};
+
+// Scheduling policy of the thread of an eventrunner
+enum class ThreadSchedPolicy: int32_t {
+    INHERIT = -1,   // keep the policy inherited from the creating thread
+    OTHER = 0,      // SCHED_OTHER
+    FIFO,           // SCHED_FIFO, real time
+    RR,             // SCHED_RR, real time
+    BATCH,          // SCHED_BATCH
+    IDLE,           // SCHED_IDLE, only runs when nothing else wants the cores
+};
+
+// Nice value meaning the thread keeps the nice value inherited from the creating thread.
+constexpr int32_t THREAD_NICE_INHERIT = INT_MAX;
+
+// Attributes of the thread of an eventrunner, applied by the thread itself before the event loop starts
+struct ThreadAttributes {
+    // Cores which the thread runs on, empty means no limit.
+    std::vector<uint32_t> cpuSet;
+    ThreadSchedPolicy schedPolicy = ThreadSchedPolicy::INHERIT;
+    // Priority for FIFO and RR policies, ignored by others.
+    int32_t schedPriority = 0;
+    // Nice value from -20 to 19.
+    int32_t niceValue = THREAD_NICE_INHERIT;
+    // Stack size in bytes, 0 means the default size.
+    size_t stackSize = 0;
+};
+
+// Statistics of an eventrunner
+struct EventRunnerStats {
+    // Count of wakeups issued to the runner thread, while it is sleeping.
+    uint64_t issuedWakeupCount {0};
+    // Count of wakeups skipped, since the runner thread is awake or has been woken up.
+    uint64_t elidedWakeupCount {0};
+    // Count of busy polls which take new events without sleeping.
+    uint64_t busyPollHitCount {0};
+    // Count of busy polls which end up sleeping, since no event comes in time.
+    uint64_t busyPollParkCount {0};
+};
+
+// Options to create an eventrunner
+struct EventRunnerOptions {
+    Mode mode = Mode::DEFAULT;
+    ThreadMode threadMode = ThreadMode::NEW_THREAD;
+    EventLockType lockType = EventLockType::STANDARD;
+    // Keep delayed events in a timing wheel, fit for lots of timeouts which are mostly removed before expiration.
+    bool useTimingWheel = false;
+    // Let posting threads hand over events through a lock free queue, fit for runners posted by many threads.
+    bool useIngressQueue = false;
+    // Wake up for delayed events with precision of nanoseconds, instead of milliseconds.
+    bool useHighResolutionWait = false;
+    // Max count of events taken from epoll by one wait, 0 means growing with the count of listened file descriptors.
+    uint32_t maxEpollEventsPerWait = 0;
+    // Spin for new events so many microseconds before sleeping, trading CPU time for latency, 0 means never.
+    // File descriptors are not listened while spinning, and ThreadMode::POOL does not spin.
+    uint32_t busyPollMicroseconds = 0;
+    // Max count of ready events picked by one scan of the queue, 1 means one by one, fit for lots of tiny tasks.
+    // Picked events are still removable, and put back if an event of higher priority is posted.
+    // Not used by ThreadMode::POOL and runners of group.
+    uint32_t pickBatchSize = 1;
+    // Count of worker threads for ThreadMode::POOL, 0 means the count of cores.
+    // Events of the same handler are distributed one by one in order, events of different handlers in parallel.
+    // Ingress queue, vsync scheduling and direct dispatch of file descriptor listeners are not used by pool.
+    uint32_t poolSize = 0;
+    // Attributes of the runner thread, or of each worker for ThreadMode::POOL, not used by ThreadMode::FFRT.
+    // See 'EventRunner::GetThreadAttributesResult' for the result.
+    ThreadAttributes threadAttributes;
 };
 
 class EventRunner final {
@@ -128,6 +198,15 @@ public:
             Mode::DEFAULT, threadMode, lockType);
     }
 
+    /**
+     * Create new 'EventRunner' and start to run in a new thread.
+     *
+     * @param threadName Thread name of the new created thread.
+     * @param options Options of the new 'EventRunner'.
+     * @return Returns shared pointer of the new 'EventRunner'.
+     */
+    static std::shared_ptr<EventRunner> Create(const std::string &threadName, const EventRunnerOptions &options);
+
     /**
      * Get event runner on current thread.
      *
@@ -176,6 +255,21 @@ public:
      */
     static std::shared_ptr<EventQueue> GetCurrentEventQueue();
 
+    /**
+     * Get statistics of the event runner.
+     *
+     * @return Returns counts of issued and elided wakeups of the runner thread.
+     */
+    EventRunnerStats GetStats() const;
+
+    /**
+     * Get the result of applying thread attributes in options, 'Create' returns after they are applied.
+     *
+     * @return Returns ERR_OK on success, EVENT_HANDLER_ERR_INVALID_PARAM for invalid attributes, or
+     * EVENT_HANDLER_ERR_RUNNER_NO_PERMIT if the process is not permitted to apply them.
+     */
+    ErrCode GetThreadAttributesResult() const;
+
     /**
      * Print out the internal information about an object in the specified format,
      * helping you diagnose internal errors of the object.
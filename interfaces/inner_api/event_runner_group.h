@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_INTERFACES_INNER_API_EVENT_RUNNER_GROUP_H
+#define BASE_EVENTHANDLER_INTERFACES_INNER_API_EVENT_RUNNER_GROUP_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "event_runner.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+class StealingGroup;
+
+// Statistics of a runner in an eventrunner group
+struct EventRunnerGroupStats {
+    // Count of tasks stolen by this runner from its peers.
+    uint64_t stolenCount {0};
+    // Count of tasks of this runner stolen by its peers.
+    uint64_t lostCount {0};
+    // Count of events waiting in the queue of this runner.
+    size_t queueDepth {0};
+};
+
+/*
+ * Group of eventrunners, each running in its own thread, whose idle runners steal ready tasks from busy peers.
+ *
+ * Only tasks of LOW and IDLE priority are stolen, tasks marked by 'InnerEvent::MarkThreadAffine' and events
+ * handled by 'EventHandler::ProcessEvent' always run in the thread of their own runner.
+ * A stolen task runs in the thread of another runner, in parallel with other events of the same handler,
+ * so handlers which post stealable tasks MUST NOT rely on their tasks running one by one.
+ */
+class EventRunnerGroup final {
+public:
+    ~EventRunnerGroup();
+    DISALLOW_COPY_AND_MOVE(EventRunnerGroup);
+
+    /**
+     * Create a group of eventrunners, and start them in new threads.
+     *
+     * @param name Prefix of thread names, the index of runner is appended.
+     * @param count Count of runners, MUST be positive.
+     * @param options Options to create each runner, only 'ThreadMode::NEW_THREAD' with 'Mode::DEFAULT' is supported.
+     * @return Returns shared pointer of the new group, or nullptr if failed.
+     */
+    static std::shared_ptr<EventRunnerGroup> Create(const std::string &name, uint32_t count,
+        const EventRunnerOptions &options = EventRunnerOptions());
+
+    /**
+     * Get count of runners in this group.
+     *
+     * @return Returns the count of runners.
+     */
+    inline uint32_t GetRunnerCount() const
+    {
+        return static_cast<uint32_t>(runners_.size());
+    }
+
+    /**
+     * Get a runner of this group.
+     *
+     * @param index Index of runner.
+     * @return Returns the runner, or nullptr if index is out of range.
+     */
+    std::shared_ptr<EventRunner> GetRunner(uint32_t index) const;
+
+    /**
+     * Get the runner of a shard key, the same key is always mapped to the same runner.
+     *
+     * @param key Shard key, such as a hash code.
+     * @return Returns the runner.
+     */
+    std::shared_ptr<EventRunner> GetRunnerByKey(uint64_t key) const;
+
+    /**
+     * Get statistics of runners, in order of their indexes.
+     *
+     * @return Returns the statistics.
+     */
+    std::vector<EventRunnerGroupStats> GetStats() const;
+
+private:
+    EventRunnerGroup() = default;
+
+    std::vector<std::shared_ptr<EventRunner>> runners_;
+    std::shared_ptr<StealingGroup> stealingGroup_;
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_INTERFACES_INNER_API_EVENT_RUNNER_GROUP_H
@@ -30,6 +30,17 @@ const uint32_t FILE_DESCRIPTOR_OUTPUT_EVENT = 2;
 const uint32_t FILE_DESCRIPTOR_SHUTDOWN_EVENT = 4;
 const uint32_t FILE_DESCRIPTOR_EXCEPTION_EVENT = 8;
 const uint32_t FILE_DESCRIPTOR_EVENTS_MASK = (FILE_DESCRIPTOR_INPUT_EVENT | FILE_DESCRIPTOR_OUTPUT_EVENT);
+// Modes of listening, which could be combined with input or output events.
+// Report events only when the file descriptor becomes ready, listener MUST read or write until EAGAIN.
+const uint32_t FILE_DESCRIPTOR_EDGE_TRIGGERED = 16;
+// Report events once, and listen again after the listener has handled them.
+const uint32_t FILE_DESCRIPTOR_ONESHOT = 32;
+// Call the listener from the running loop directly instead of posting a task, listener MUST NOT block.
+const uint32_t FILE_DESCRIPTOR_DIRECT_DISPATCH = 64;
+// Keep at most one pending call of the listener, events reported before it are merged into it.
+const uint32_t FILE_DESCRIPTOR_COALESCED = 128;
+const uint32_t FILE_DESCRIPTOR_MODES_MASK = (FILE_DESCRIPTOR_EDGE_TRIGGERED | FILE_DESCRIPTOR_ONESHOT |
+    FILE_DESCRIPTOR_DIRECT_DISPATCH | FILE_DESCRIPTOR_COALESCED);
 
 class EventHandler;
 
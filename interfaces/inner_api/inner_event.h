@@ -25,6 +25,7 @@
 #include <variant>
 
 #include "nocopyable.h"
+#include "task_callable.h"
 
 namespace OHOS {
 namespace HiviewDFX {
@@ -39,40 +40,70 @@ class EventHandler;
 
 constexpr const char* LINE_SEPARATOR = "\n";
 
+/*
+ * Caller info of an event.
+ *
+ * Strings are kept as pointers, so that it is cheap to copy caller info while posting and distributing events.
+ * File and function names from __builtin_FILE() and __builtin_FUNCTION() are string literals and stored directly,
+ * other strings are interned and never released.
+ */
 struct Caller {
-    std::string file_ {""};
+    const char *file_ {""};
     int         line_ {0};
-    std::string func_ {""};
-    std::string dfxName_ {""};
+    const char *func_ {""};
+    const char *dfxName_ {""};
 #if __has_builtin(__builtin_FILE)
-    Caller(std::string file = __builtin_FILE(), int line = __builtin_LINE(),
-           std::string func = __builtin_FUNCTION())
+    Caller(const char *file = __builtin_FILE(), int line = __builtin_LINE(),
+           const char *func = __builtin_FUNCTION())
         : file_(file), line_(line), func_(func) {}
 #else
     Caller() {}
 #endif
-    std::string ToString() const
-    {
-        if (file_.empty()) {
-            return std::string("[ ]");
-        }
-        size_t split = file_.find_last_of("/\\");
-        if (split == std::string::npos) {
-            split = 0;
-        }
-        std::string caller("[" + file_.substr(split + 1) + "(" + func_ + ":" + std::to_string(line_) +
-            dfxName_ + ")]");
-        return caller;
-    }
+    Caller(const std::string &file, int line, const std::string &func);
+
+    /**
+     * Set name for dfx, which is appended to caller info.
+     *
+     * @param dfxName Name for dfx.
+     */
+    void SetDfxName(const std::string &dfxName);
 
-    void ClearCaller()
+    /**
+     * Format caller info, only used for dumping and tracing.
+     *
+     * @return Returns caller info as "[file(func:line)]".
+     */
+    std::string ToString() const;
+
+    inline void ClearCaller()
     {
         file_ = "";
         func_ = "";
         line_ = 0;
+        dfxName_ = "";
     }
 };
 
+struct InnerEventPoolStats {
+    // Count of events taken from the pool.
+    uint64_t hitCount {0};
+    // Count of events allocated while the pool is empty.
+    uint64_t missCount {0};
+    // Count of events currently kept by the pool.
+    size_t pooledCount {0};
+    // Maximum count of events ever kept by the pool.
+    size_t highWaterCount {0};
+};
+
+class InnerEvent;
+
+// Intrusive link of an event in the indexes of event queue.
+struct EventIndexLink {
+    EventIndexLink *prev {nullptr};
+    EventIndexLink *next {nullptr};
+    InnerEvent *event {nullptr};
+};
+
 class InnerEvent final {
 public:
     using Clock = std::chrono::steady_clock;
@@ -411,6 +442,16 @@ public:
     static Pointer Get(const Callback &callback, const std::string &name = std::string(),
                        const Caller &caller = {});
 
+    /**
+     * Get InnerEvent instance from pool.
+     *
+     * @param task Move-only callable for task, it is stored in the event without extra allocation if small enough.
+     * @param name Name of task.
+     * @param caller Caller info of the event, default is caller's file, func and line.
+     * @return Returns the pointer of InnerEvent instance, if task is empty, returns nullptr object.
+     */
+    static Pointer Get(TaskCallable &&task, const std::string &name = std::string(), const Caller &caller = {});
+
     /**
      * Get InnerEvent instance from pool.
      *
@@ -418,6 +459,13 @@ public:
      */
     static Pointer Get();
 
+    /**
+     * Get statistics of the event pool, used to size the pool.
+     *
+     * @return Returns hit, miss and high-water counters of the event pool.
+     */
+    static InnerEventPoolStats GetPoolStats();
+
     /**
      * Get owner of the event.
      *
@@ -615,11 +663,20 @@ public:
      * Get task callback.
      * Make sure {@link #hasTask} returns true.
      *
+     * Tasks not posted as a Callback are wrapped into a Callback at the first call, which costs an allocation,
+     * use {@link #RunTask} to run tasks of any kind without it.
+     *
      * @return Returns the callback of the task.
      */
-    inline const Callback &GetTaskCallback() const
+    const Callback &GetTaskCallback() const;
+
+    /**
+     * Run the task of event.
+     * Make sure {@link #hasTask} returns true.
+     */
+    inline void RunTask()
     {
-        return taskCallback_;
+        task_();
     }
 
     /**
@@ -649,7 +706,7 @@ public:
      */
     inline bool HasTask() const
     {
-        return static_cast<bool>(taskCallback_);
+        return static_cast<bool>(task_);
     }
 
     /**
@@ -688,18 +745,28 @@ public:
     void ReleaseStackId();
 
     /**
-     * Set uniqueId in event.
+     * Set uniqueId in event, which is a sequence number increasing monotonically in process.
      */
     void SetEventUniqueId();
 
     /**
-     * Get uniqueId for event.
+     * Get uniqueId for event, it is formatted on demand.
      *
      * @return Returns uniqueId for event.
      */
-    inline std::string GetEventUniqueId()
+    inline std::string GetEventUniqueId() const
     {
-        return eventId;
+        return std::to_string(eventUniqueId_);
+    }
+
+    /**
+     * Get uniqueId for event as a number.
+     *
+     * @return Returns uniqueId for event, 0 if not set.
+     */
+    inline uint64_t GetEventUniqueIdValue() const
+    {
+        return eventUniqueId_;
     }
 
     /**
@@ -721,19 +788,30 @@ public:
     }
 
     /**
-     * Set ownerId.
+     * Set ownerId, which is the string id of the owner handler, see {@link EventHandler#GetHandlerId}.
+     * The numeric id at the head of it is used as the owner numeric id.
+     */
+    void SetOwnerId(std::string ownerId);
+
+    /**
+     * Get ownerId, which is the string id of the owner handler, or empty if not owned by a handler alive.
      */
-    inline void SetOwnerId(std::string ownerId)
+    std::string GetOwnerId();
+
+    /**
+     * Set owner numeric id, which is the numeric id of the owner handler, see {@link EventHandler#GetHandlerNumericId}.
+     */
+    inline void SetOwnerNumericId(uint64_t ownerId)
     {
-        ownerId_ = ownerId;
+        ownerNumericId_ = ownerId;
     }
 
     /**
-     * Get ownerId.
+     * Get owner numeric id, 0 means no owner.
      */
-    inline std::string GetOwnerId()
+    inline uint64_t GetOwnerNumericId() const
     {
-        return ownerId_;
+        return ownerNumericId_;
     }
 
     /**
@@ -784,6 +862,22 @@ public:
         return isBarrier_;
     }
 
+    /**
+     * Mark the event must be handled by the thread of its runner, never stolen by peers in 'EventRunnerGroup'.
+     */
+    inline void MarkThreadAffine()
+    {
+        isThreadAffine_ = true;
+    }
+
+    /**
+     * Check the event must be handled by the thread of its runner.
+     */
+    inline bool IsThreadAffine() const
+    {
+        return isThreadAffine_;
+    }
+
     /**
      * Mark the event sent by enhanced api.
      */
@@ -802,32 +896,48 @@ public:
 
     inline void SetEmitterId(uint32_t emitterId)
     {
-        emitterId_ = emitterId;
+        if ((emitterId != 0) || diagnostics_) {
+            GetDiagnostics().emitterId = emitterId;
+        }
     }
 
     inline uint32_t GetEmitterId()
     {
-        return emitterId_;
+        return diagnostics_ ? diagnostics_->emitterId : 0;
     }
 
     inline void SetStackId(uint64_t stackId)
     {
         ReleaseStackId();
-        stackId_ = stackId;
+        if ((stackId != 0) || diagnostics_) {
+            GetDiagnostics().stackId = stackId;
+        }
     }
 
     inline uint64_t GetStackId()
     {
-        return stackId_;
+        return diagnostics_ ? diagnostics_->stackId : 0;
     }
 private:
     using SmartPtrDestructor = void (*)(void *);
 
-    InnerEvent() = default;
+    // Diagnostics which are rarely used, allocated on demand and kept while the event is recycled.
+    struct Diagnostics {
+        std::shared_ptr<HiTraceId> hiTraceId;
+        uint64_t stackId {0};
+        uint32_t emitterId {0};
+        // String form of owner id, only set by 'SetOwnerId'.
+        std::string ownerId;
+    };
+
+    InnerEvent() : isVsync_(false), isBarrier_(false), isEnhanced_(false), isThreadAffine_(false), isDiscarded_(false),
+        queueLocation_(0) {}
     ~InnerEvent() = default;
 
     void ClearEvent();
 
+    Diagnostics &GetDiagnostics();
+
     static void WarnSmartPtrCastMismatch();
 
     template<typename T>
@@ -927,54 +1037,68 @@ private:
     friend class InnerEventPool;
     // Let event handler to access private interface.
     friend class EventHandler;
+    // Let event queue to keep the bookkeeping of queued events.
+    friend class EventIndex;
+    // Let ingress queue of event queue to chain the posted events.
+    friend class IngressQueue;
 
-    std::weak_ptr<EventHandler> owner_;
+    // Take back the ownership of an event released from pointer, all events are created by event pool.
+    static Pointer Adopt(InnerEvent *event);
+
+    // Hot fields, which are read while inserting, picking and removing events, keep them in the first cache line.
     TimePoint handleTime_;
     TimePoint sendTime_;
-    uint64_t senderKernelThreadId_{0};
+    uint64_t ownerNumericId_ = 0;
+
+    // Simple parameter for the event.
+    int64_t param_{0};
+
+    int32_t priority = -1;
+    bool isVsync_ : 1;
+    bool isBarrier_ : 1;
+    bool isEnhanced_ : 1;
+    bool isThreadAffine_ : 1;
+    // Bookkeeping of event queue, only accessed with the lock of event queue held.
+    bool isDiscarded_ : 1;
+    uint8_t queueLocation_ : 2;
+
+    std::weak_ptr<EventHandler> owner_;
 
     // Event id of the event, if it is not a task object
     EventId innerEventId_ = 0u;
 
-    // Simple parameter for the event.
-    int64_t param_{0};
+    // Task callable and its name.
+    // Mutable, since it may be converted into a callback by 'GetTaskCallback'.
+    mutable TaskCallable task_;
+    std::string taskName_;
 
     // Using to save smart pointer
     size_t smartPtrTypeId_{0};
     void *smartPtr_{nullptr};
     SmartPtrDestructor smartPtrDtor_{nullptr};
 
-    // Task callback and its name.
-    Callback taskCallback_;
-    std::string taskName_;
-
-    // Task event caller info
-    Caller caller_;
-
     // Used for synchronized event.
     std::shared_ptr<Waiter> waiter_;
 
-    // use to store hitrace Id
-    std::shared_ptr<HiTraceId> hiTraceId_;
-
-    // use to store event unique Id
-    std::string eventId;
-
-    uint32_t emitterId_ = 0;
+    // Bookkeeping of event queue, only accessed with the lock of event queue held.
+    EventIndexLink ownerLink_;
+    EventIndexLink keyLink_;
 
-    int32_t priority = -1;
+    // Bookkeeping of ingress queue, written by the posting thread before the event is published.
+    InnerEvent *ingressNext_ {nullptr};
 
-    bool isVsync_ = false;
+    // Cold fields, only used for dumping, tracing and some special events.
+    // Task event caller info
+    Caller caller_;
 
-    bool isBarrier_ = false;
+    uint64_t senderKernelThreadId_{0};
 
-    std::string ownerId_;
+    // use to store event unique Id
+    uint64_t eventUniqueId_ = 0;
 
     int64_t delayTime_ = 0;
 
-    bool isEnhanced_ = false;
-
-    uint64_t stackId_ = 0;
+    std::unique_ptr<Diagnostics> diagnostics_;
 };
 }  // namespace AppExecFwk
 }  // namespace OHOS
@@ -109,7 +109,11 @@ private:
 
 enum class EventLockType {
     STANDARD,
-    PRIORITY_INHERIT
+    PRIORITY_INHERIT,
+    // Spin for a while before sleeping, fit for queues posted by many threads.
+    ADAPTIVE,
+    // Adaptive lock which falls back to a priority inheritance futex after spinning.
+    ADAPTIVE_PRIORITY_INHERIT
 };
 
 } // namespace AppExecFwk
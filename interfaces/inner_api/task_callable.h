@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef BASE_EVENTHANDLER_INTERFACES_INNER_API_TASK_CALLABLE_H
+#define BASE_EVENTHANDLER_INTERFACES_INNER_API_TASK_CALLABLE_H
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "nocopyable.h"
+
+namespace OHOS {
+namespace AppExecFwk {
+/*
+ * Move-only callable of a task.
+ *
+ * Callables no larger than INLINE_SIZE bytes, such as lambdas capturing a few smart pointers, are stored in place,
+ * so that posting them costs no allocation. Larger callables are stored on heap like std::function.
+ * Unlike std::function, callables are not required to be copyable, so it could hold lambdas capturing unique_ptr.
+ */
+class TaskCallable final {
+public:
+    using Callback = std::function<void()>;
+
+    static constexpr size_t INLINE_SIZE = 48;
+
+    TaskCallable() noexcept = default;
+
+    TaskCallable(std::nullptr_t) noexcept {}
+
+    /**
+     * Construct from a callable object, an empty std::function or a null function pointer makes an empty task.
+     *
+     * @param callable Callable object which could be invoked without arguments.
+     */
+    template<typename F, typename Fn = std::decay_t<F>,
+        typename = std::enable_if_t<!std::is_same_v<Fn, TaskCallable> && std::is_invocable_v<Fn &>>>
+    explicit TaskCallable(F &&callable)
+    {
+        if constexpr (std::is_pointer_v<Fn> || std::is_same_v<Fn, Callback>) {
+            if (!callable) {
+                return;
+            }
+        }
+        if constexpr (IS_INLINE<Fn>) {
+            new (storage_) Fn(std::forward<F>(callable));
+            ops_ = &InlineOps<Fn>::OPS;
+        } else {
+            *reinterpret_cast<Fn **>(storage_) = new Fn(std::forward<F>(callable));
+            ops_ = &HeapOps<Fn>::OPS;
+        }
+    }
+
+    TaskCallable(TaskCallable &&other) noexcept
+    {
+        MoveFrom(other);
+    }
+
+    TaskCallable &operator=(TaskCallable &&other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    TaskCallable &operator=(std::nullptr_t) noexcept
+    {
+        Reset();
+        return *this;
+    }
+
+    ~TaskCallable()
+    {
+        Reset();
+    }
+
+    DISALLOW_COPY(TaskCallable);
+
+    explicit operator bool() const noexcept
+    {
+        return ops_ != nullptr;
+    }
+
+    /**
+     * Invoke the callable, make sure it is not empty.
+     */
+    void operator()()
+    {
+        ops_->invoke(storage_);
+    }
+
+    /**
+     * Get the std::function held by this task, for tasks constructed from std::function.
+     *
+     * @return Returns the std::function, or nullptr if the task holds another kind of callable.
+     */
+    const Callback *GetCallback() const noexcept
+    {
+        return ((ops_ != nullptr) && ops_->isCallback) ? reinterpret_cast<const Callback *>(storage_) : nullptr;
+    }
+
+    /**
+     * Convert the task into a std::function in place, so that it could be called as a callback.
+     * Callables other than std::function are moved into the std::function through a shared pointer,
+     * since std::function requires them to be copyable, which costs an allocation.
+     *
+     * @return Returns the std::function, which is empty if the task is empty.
+     */
+    const Callback &ToCallback()
+    {
+        static const Callback emptyCallback;
+        if (ops_ == nullptr) {
+            return emptyCallback;
+        }
+        if (!ops_->isCallback) {
+            auto callable = std::make_shared<TaskCallable>(std::move(*this));
+            *this = TaskCallable(Callback([callable]() { (*callable)(); }));
+        }
+        return *reinterpret_cast<const Callback *>(storage_);
+    }
+
+    /**
+     * Check whether the callable is stored in place.
+     *
+     * @return Returns true if the callable is stored in place, or the task is empty.
+     */
+    bool IsInline() const noexcept
+    {
+        return (ops_ == nullptr) || ops_->isInline;
+    }
+
+private:
+    struct Ops {
+        void (*invoke)(void *storage);
+        // Move the callable into 'dst', and destroy the one left in 'src'.
+        void (*relocate)(void *dst, void *src) noexcept;
+        void (*destroy)(void *storage) noexcept;
+        bool isInline;
+        bool isCallback;
+    };
+
+    template<typename Fn>
+    static constexpr bool IS_INLINE = (sizeof(Fn) <= INLINE_SIZE) && (alignof(Fn) <= alignof(void *)) &&
+        std::is_nothrow_move_constructible_v<Fn>;
+
+    template<typename Fn>
+    struct InlineOps {
+        static void Invoke(void *storage)
+        {
+            (*static_cast<Fn *>(storage))();
+        }
+
+        static void Relocate(void *dst, void *src) noexcept
+        {
+            new (dst) Fn(std::move(*static_cast<Fn *>(src)));
+            static_cast<Fn *>(src)->~Fn();
+        }
+
+        static void Destroy(void *storage) noexcept
+        {
+            static_cast<Fn *>(storage)->~Fn();
+        }
+
+        static constexpr Ops OPS = {Invoke, Relocate, Destroy, true, std::is_same_v<Fn, Callback>};
+    };
+
+    template<typename Fn>
+    struct HeapOps {
+        static void Invoke(void *storage)
+        {
+            (**static_cast<Fn **>(storage))();
+        }
+
+        static void Relocate(void *dst, void *src) noexcept
+        {
+            *static_cast<Fn **>(dst) = *static_cast<Fn **>(src);
+        }
+
+        static void Destroy(void *storage) noexcept
+        {
+            delete *static_cast<Fn **>(storage);
+        }
+
+        static constexpr Ops OPS = {Invoke, Relocate, Destroy, false, false};
+    };
+
+    void MoveFrom(TaskCallable &other) noexcept
+    {
+        if (other.ops_ != nullptr) {
+            other.ops_->relocate(storage_, other.storage_);
+            ops_ = other.ops_;
+            other.ops_ = nullptr;
+        }
+    }
+
+    void Reset() noexcept
+    {
+        if (ops_ != nullptr) {
+            ops_->destroy(storage_);
+            ops_ = nullptr;
+        }
+    }
+
+    static_assert(IS_INLINE<Callback>, "std::function should be stored in place");
+
+    const Ops *ops_ {nullptr};
+    alignas(void *) unsigned char storage_[INLINE_SIZE];
+};
+}  // namespace AppExecFwk
+}  // namespace OHOS
+
+#endif  // #ifndef BASE_EVENTHANDLER_INTERFACES_INNER_API_TASK_CALLABLE_H
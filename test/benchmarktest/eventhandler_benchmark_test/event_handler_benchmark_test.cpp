@@ -0,0 +1,666 @@
+/*
+ * Copyright (c) 2025 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include "event_handler.h"
+#include "event_runner.h"
+#include "event_runner_group.h"
+#include "file_descriptor_listener.h"
+#include "inner_event.h"
+
+using namespace OHOS;
+using namespace OHOS::AppExecFwk;
+
+namespace {
+const uint32_t EVENT_ID = 1;
+const int64_t EVENT_DELAY_TIME = 1000;
+std::atomic<uint64_t> g_allocCount {0};
+
+/**
+ * Report heap allocations per iteration of a benchmark.
+ */
+class AllocCounter {
+public:
+    explicit AllocCounter(benchmark::State &state) : state_(state), start_(g_allocCount.load()) {}
+    ~AllocCounter()
+    {
+        state_.counters["allocs"] = benchmark::Counter(static_cast<double>(g_allocCount.load() - start_),
+            benchmark::Counter::kAvgIterations);
+    }
+
+private:
+    benchmark::State &state_;
+    uint64_t start_;
+};
+
+/**
+ * Record how late events are processed after their handle time.
+ */
+class LatencyHandler : public EventHandler {
+public:
+    explicit LatencyHandler(const std::shared_ptr<EventRunner> &runner) : EventHandler(runner) {}
+    ~LatencyHandler() override = default;
+
+    void ProcessEvent(const InnerEvent::Pointer &event) override
+    {
+        auto lateness = InnerEvent::Clock::now() - event->GetHandleTime();
+        std::lock_guard<std::mutex> lock(mutex_);
+        lateness_ = std::chrono::duration_cast<std::chrono::nanoseconds>(lateness).count();
+        processed_ = true;
+        condition_.notify_one();
+    }
+
+    int64_t WaitForLateness()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return processed_; });
+        processed_ = false;
+        return lateness_;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool processed_ {false};
+    int64_t lateness_ {0};
+};
+
+class IdleListener : public FileDescriptorListener {
+public:
+    IdleListener() = default;
+    ~IdleListener() override = default;
+};
+
+/**
+ * Read a byte written by the benchmark thread, and tell it back.
+ */
+class PingListener : public FileDescriptorListener {
+public:
+    PingListener() = default;
+    ~PingListener() override = default;
+
+    void OnReadable(int32_t fileDescriptor) override
+    {
+        char buffer = 0;
+        (void)read(fileDescriptor, &buffer, sizeof(buffer));
+        std::lock_guard<std::mutex> lock(mutex_);
+        read_ = true;
+        condition_.notify_one();
+    }
+
+    void WaitForRead()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_.wait(lock, [this]() { return read_; });
+        read_ = false;
+    }
+
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    bool read_ {false};
+};
+}  // namespace
+
+void *operator new(size_t size)
+{
+    g_allocCount.fetch_add(1, std::memory_order_relaxed);
+    void *ptr = std::malloc((size == 0) ? 1 : size);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+/**
+ * Unique id formatted from time for every event, as it was done before events carry a sequence number.
+ */
+static void BenchmarkFormatTimeAsUniqueId(benchmark::State &state)
+{
+    std::string eventId;
+    AllocCounter counter(state);
+    for (auto _ : state) {
+        auto nowTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        eventId = std::to_string(nowTime);
+        benchmark::DoNotOptimize(eventId);
+    }
+}
+BENCHMARK(BenchmarkFormatTimeAsUniqueId);
+
+static void BenchmarkSetEventUniqueId(benchmark::State &state)
+{
+    auto event = InnerEvent::Get(EVENT_ID);
+    AllocCounter counter(state);
+    for (auto _ : state) {
+        event->SetEventUniqueId();
+        benchmark::DoNotOptimize(event->GetEventUniqueIdValue());
+    }
+}
+BENCHMARK(BenchmarkSetEventUniqueId);
+
+/**
+ * Post a delayed event and remove it, the runner is not started so that the event stays in queue.
+ */
+static void BenchmarkSendAndRemoveEvent(benchmark::State &state)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    AllocCounter counter(state);
+    for (auto _ : state) {
+        handler->SendEvent(EVENT_ID, 0, EVENT_DELAY_TIME);
+        handler->RemoveEvent(EVENT_ID);
+    }
+}
+BENCHMARK(BenchmarkSendAndRemoveEvent);
+
+/**
+ * Scan queued events like a barrier check does, it reads handle time and flags of every event.
+ */
+static void BenchmarkScanEvents(benchmark::State &state)
+{
+    auto now = InnerEvent::Clock::now();
+    std::vector<InnerEvent::Pointer> events;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        auto event = InnerEvent::Get(EVENT_ID, i);
+        event->SetHandleTime(now + std::chrono::milliseconds(i));
+        events.emplace_back(std::move(event));
+    }
+    for (auto _ : state) {
+        size_t count = 0;
+        for (auto &event : events) {
+            if (event->IsBarrierTask() && (event->GetHandleTime() <= now)) {
+                ++count;
+            }
+        }
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BenchmarkScanEvents)->Arg(1024)->Arg(65536);
+
+/**
+ * Post a delayed task capturing two shared pointers and remove it, wrapping the task in a std::function first.
+ */
+static void BenchmarkPostAndRemoveCallback(benchmark::State &state)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto first = std::make_shared<int>(0);
+    auto second = std::make_shared<int>(0);
+    const std::string name = "task";
+    AllocCounter counter(state);
+    for (auto _ : state) {
+        EventHandler::Callback callback = [first, second]() { ++(*first); ++(*second); };
+        handler->PostTask(callback, name, EVENT_DELAY_TIME);
+        handler->RemoveTask(name);
+    }
+}
+BENCHMARK(BenchmarkPostAndRemoveCallback);
+
+/**
+ * Post the same task as a lambda, which is stored in the event in place.
+ */
+static void BenchmarkPostAndRemoveTask(benchmark::State &state)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    auto first = std::make_shared<int>(0);
+    auto second = std::make_shared<int>(0);
+    const std::string name = "task";
+    AllocCounter counter(state);
+    for (auto _ : state) {
+        handler->PostTask([first, second]() { ++(*first); ++(*second); }, name, EVENT_DELAY_TIME);
+        handler->RemoveTask(name);
+    }
+}
+BENCHMARK(BenchmarkPostAndRemoveTask);
+
+/**
+ * Post a burst of tasks one by one, the lock of queue is taken for every task.
+ */
+static void BenchmarkPostTasksOneByOne(benchmark::State &state)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            handler->PostTask([]() {});
+        }
+        state.PauseTiming();
+        handler->RemoveAllEvents();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BenchmarkPostTasksOneByOne)->Arg(64)->Arg(512);
+
+/**
+ * Post the same burst of tasks in a batch.
+ */
+static void BenchmarkPostTasksInBatch(benchmark::State &state)
+{
+    auto runner = EventRunner::Create(false);
+    auto handler = std::make_shared<EventHandler>(runner);
+    std::vector<TaskSpec> tasks;
+    for (auto _ : state) {
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            tasks.emplace_back([]() {});
+        }
+        handler->PostTasks(tasks);
+        state.PauseTiming();
+        tasks.clear();
+        handler->RemoveAllEvents();
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BenchmarkPostTasksInBatch)->Arg(64)->Arg(512);
+
+/**
+ * Get current runner from many threads at the same time, as handlers and vsync tasks do.
+ */
+static void BenchmarkCurrentRunner(benchmark::State &state)
+{
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(EventRunner::Current());
+    }
+}
+BENCHMARK(BenchmarkCurrentRunner)->Threads(1)->Threads(32);
+
+/**
+ * Post tasks from many threads to a running runner, through the locked queue (0) or the ingress queue (1).
+ */
+static void BenchmarkPostFromThreads(benchmark::State &state)
+{
+    static std::shared_ptr<EventRunner> runner;
+    static std::shared_ptr<EventHandler> handler;
+    if (state.thread_index() == 0) {
+        EventRunnerOptions options;
+        options.useIngressQueue = (state.range(0) != 0);
+        runner = EventRunner::Create(std::string("BenchmarkPostFromThreads"), options);
+        handler = std::make_shared<EventHandler>(runner);
+    }
+    for (auto _ : state) {
+        handler->PostTask([]() {});
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        EventRunnerStats stats = runner->GetStats();
+        state.counters["issued_wakeups"] = static_cast<double>(stats.issuedWakeupCount);
+        state.counters["elided_wakeups"] = static_cast<double>(stats.elidedWakeupCount);
+        handler->RemoveAllEvents();
+        handler.reset();
+        runner.reset();
+    }
+}
+BENCHMARK(BenchmarkPostFromThreads)->Arg(0)->Arg(1)->Threads(1)->Threads(4)->Threads(16)->UseRealTime();
+
+/**
+ * Insert events without contention, for each lock type: STANDARD (0), PRIORITY_INHERIT (1), ADAPTIVE (2) and
+ * ADAPTIVE_PRIORITY_INHERIT (3).
+ */
+static void BenchmarkInsertUncontended(benchmark::State &state)
+{
+    constexpr int64_t batchSize = 1024;
+    auto runner = EventRunner::Create(false, ThreadMode::NEW_THREAD, static_cast<EventLockType>(state.range(0)));
+    auto handler = std::make_shared<EventHandler>(runner);
+    int64_t count = 0;
+    for (auto _ : state) {
+        handler->SendEvent(1);
+        if (++count == batchSize) {
+            state.PauseTiming();
+            handler->RemoveAllEvents();
+            count = 0;
+            state.ResumeTiming();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BenchmarkInsertUncontended)->DenseRange(0, 3);
+
+/**
+ * Insert events from 8 threads into a running runner, for each lock type as above.
+ */
+static void BenchmarkInsertContended(benchmark::State &state)
+{
+    static std::shared_ptr<EventRunner> runner;
+    static std::shared_ptr<EventHandler> handler;
+    if (state.thread_index() == 0) {
+        EventRunnerOptions options;
+        options.lockType = static_cast<EventLockType>(state.range(0));
+        runner = EventRunner::Create(std::string("BenchmarkInsertContended"), options);
+        handler = std::make_shared<EventHandler>(runner);
+    }
+    for (auto _ : state) {
+        handler->SendEvent(1);
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0) {
+        handler->RemoveAllEvents();
+        handler.reset();
+        runner.reset();
+    }
+}
+BENCHMARK(BenchmarkInsertContended)->DenseRange(0, 3)->Threads(8)->UseRealTime();
+
+/**
+ * Distribution of wake-up lateness of delayed events on an epoll based runner, with the default millisecond
+ * wait (0) or the high resolution wait (1). The second argument is the delay in microseconds.
+ */
+static void BenchmarkWakeUpLatency(benchmark::State &state)
+{
+    EventRunnerOptions options;
+    options.useHighResolutionWait = (state.range(0) != 0);
+    auto runner = EventRunner::Create(std::string("BenchmarkWakeUpLatency"), options);
+    auto handler = std::make_shared<LatencyHandler>(runner);
+
+    // Listening to a file descriptor makes the runner wait by epoll.
+    int32_t fds[2] = {-1, -1};
+    if (pipe(fds) != 0) {
+        state.SkipWithError("failed to create pipe");
+        return;
+    }
+    handler->AddFileDescriptorListener(fds[0], FILE_DESCRIPTOR_INPUT_EVENT, std::make_shared<IdleListener>(),
+        "BenchmarkWakeUpLatency");
+
+    auto delay = std::chrono::microseconds(state.range(1));
+    std::vector<int64_t> lateness;
+    for (auto _ : state) {
+        auto event = InnerEvent::Get(EVENT_ID);
+        auto now = InnerEvent::Clock::now();
+        event->SetSendTime(now);
+        event->SetHandleTime(now + delay);
+        event->SetOwner(handler);
+        event->SetOwnerNumericId(handler->GetHandlerNumericId());
+        runner->GetEventQueue()->Insert(event);
+        lateness.push_back(handler->WaitForLateness());
+    }
+
+    handler->RemoveAllFileDescriptorListeners();
+    close(fds[0]);
+    close(fds[1]);
+    if (lateness.empty()) {
+        return;
+    }
+    std::sort(lateness.begin(), lateness.end());
+    constexpr double nsPerUs = 1000.0;
+    constexpr size_t percentile50 = 50;
+    constexpr size_t percentile99 = 99;
+    constexpr size_t percentAll = 100;
+    state.counters["late_p50_us"] = lateness[lateness.size() * percentile50 / percentAll] / nsPerUs;
+    state.counters["late_p99_us"] = lateness[lateness.size() * percentile99 / percentAll] / nsPerUs;
+    state.counters["late_max_us"] = lateness.back() / nsPerUs;
+}
+BENCHMARK(BenchmarkWakeUpLatency)->ArgsProduct({{0, 1}, {100, 500, 1000, 2000}})->Iterations(200)->UseRealTime();
+
+/**
+ * Latency from writing a file descriptor to its listener being called, through a posted task (0) or
+ * direct dispatch from the running loop (1).
+ */
+static void BenchmarkFileDescriptorDispatch(benchmark::State &state)
+{
+    auto runner = EventRunner::Create(true);
+    auto handler = std::make_shared<EventHandler>(runner);
+    int32_t fds[2] = {-1, -1};
+    if (pipe(fds) != 0) {
+        state.SkipWithError("failed to create pipe");
+        return;
+    }
+    uint32_t events = FILE_DESCRIPTOR_INPUT_EVENT;
+    if (state.range(0) != 0) {
+        events |= FILE_DESCRIPTOR_DIRECT_DISPATCH;
+    }
+    auto listener = std::make_shared<PingListener>();
+    handler->AddFileDescriptorListener(fds[0], events, listener, "BenchmarkFileDescriptorDispatch");
+
+    {
+        AllocCounter counter(state);
+        for (auto _ : state) {
+            (void)write(fds[1], "x", 1);
+            listener->WaitForRead();
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+    handler->RemoveFileDescriptorListener(fds[0]);
+    close(fds[0]);
+    close(fds[1]);
+}
+BENCHMARK(BenchmarkFileDescriptorDispatch)->Arg(0)->Arg(1)->UseRealTime();
+
+/**
+ * Throughput of CPU bound tasks posted to 16 handlers, on a runner with a pool of 1 to 16 workers.
+ */
+static void BenchmarkPoolScaling(benchmark::State &state)
+{
+    constexpr uint32_t handlerCount = 16;
+    constexpr uint32_t tasksPerHandler = 8;
+    constexpr uint32_t workPerTask = 20000;
+    EventRunnerOptions options;
+    options.threadMode = ThreadMode::POOL;
+    options.poolSize = static_cast<uint32_t>(state.range(0));
+    auto runner = EventRunner::Create(std::string("BenchmarkPoolScaling"), options);
+    std::vector<std::shared_ptr<EventHandler>> handlers;
+    for (uint32_t i = 0; i < handlerCount; ++i) {
+        handlers.emplace_back(std::make_shared<EventHandler>(runner));
+    }
+
+    std::mutex lock;
+    std::condition_variable condition;
+    uint32_t remaining = 0;
+    auto task = [&lock, &condition, &remaining]() {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < workPerTask; ++i) {
+            value += static_cast<uint64_t>(i) * i;
+            benchmark::DoNotOptimize(value);
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if (--remaining == 0) {
+            condition.notify_one();
+        }
+    };
+    for (auto _ : state) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            remaining = handlerCount * tasksPerHandler;
+        }
+        for (uint32_t i = 0; i < tasksPerHandler; ++i) {
+            for (auto &handler : handlers) {
+                handler->PostTask(task);
+            }
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        condition.wait(guard, [&remaining]() { return remaining == 0; });
+    }
+    state.SetItemsProcessed(state.iterations() * handlerCount * tasksPerHandler);
+}
+BENCHMARK(BenchmarkPoolScaling)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+/*
+ * All tasks are posted to one runner of a group, range(0) is 1 if they could be stolen by idle peers,
+ * or 0 if they are thread affine.
+ */
+static void BenchmarkRunnerGroupSkewedLoad(benchmark::State &state)
+{
+    constexpr uint32_t runnerCount = 4;
+    constexpr uint32_t taskCount = 64;
+    constexpr uint32_t workPerTask = 20000;
+    bool stealable = (state.range(0) != 0);
+    auto group = EventRunnerGroup::Create("BenchmarkRunnerGroup", runnerCount);
+    auto handler = std::make_shared<EventHandler>(group->GetRunner(0));
+
+    std::mutex lock;
+    std::condition_variable condition;
+    uint32_t remaining = 0;
+    auto task = [&lock, &condition, &remaining]() {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < workPerTask; ++i) {
+            value += static_cast<uint64_t>(i) * i;
+            benchmark::DoNotOptimize(value);
+        }
+        std::lock_guard<std::mutex> guard(lock);
+        if (--remaining == 0) {
+            condition.notify_one();
+        }
+    };
+    for (auto _ : state) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            remaining = taskCount;
+        }
+        std::vector<TaskSpec> tasks;
+        tasks.reserve(taskCount);
+        for (uint32_t i = 0; i < taskCount; ++i) {
+            tasks.emplace_back(task);
+            tasks.back().threadAffine = !stealable;
+        }
+        handler->PostTasks(tasks);
+        std::unique_lock<std::mutex> guard(lock);
+        condition.wait(guard, [&remaining]() { return remaining == 0; });
+    }
+    state.SetItemsProcessed(state.iterations() * taskCount);
+    auto stats = group->GetStats();
+    state.counters["stolen_ratio"] = static_cast<double>(stats[0].lostCount) /
+        static_cast<double>(std::max<int64_t>(state.iterations() * taskCount, 1));
+}
+BENCHMARK(BenchmarkRunnerGroupSkewedLoad)->Arg(0)->Arg(1)->UseRealTime();
+
+/**
+ * Distribution of latency from posting a task to running it on an idle runner, which sleeps at once (0)
+ * or busy polls for the given microseconds before sleeping.
+ */
+static void BenchmarkBusyPollLatency(benchmark::State &state)
+{
+    EventRunnerOptions options;
+    options.busyPollMicroseconds = static_cast<uint32_t>(state.range(0));
+    auto runner = EventRunner::Create(std::string("BenchmarkBusyPollLatency"), options);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    std::mutex lock;
+    std::condition_variable condition;
+    bool done = false;
+    std::vector<int64_t> latency;
+    for (auto _ : state) {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            done = false;
+        }
+        auto postTime = InnerEvent::Clock::now();
+        handler->PostTask([&lock, &condition, &done, &latency, postTime]() {
+            auto elapsed = InnerEvent::Clock::now() - postTime;
+            std::lock_guard<std::mutex> guard(lock);
+            latency.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+            done = true;
+            condition.notify_one();
+        });
+        std::unique_lock<std::mutex> guard(lock);
+        condition.wait(guard, [&done]() { return done; });
+    }
+    auto stats = runner->GetStats();
+    if (latency.empty()) {
+        return;
+    }
+    std::sort(latency.begin(), latency.end());
+    constexpr double nsPerUs = 1000.0;
+    constexpr size_t percentile50 = 50;
+    constexpr size_t percentile99 = 99;
+    constexpr size_t percentAll = 100;
+    state.counters["latency_p50_us"] = latency[latency.size() * percentile50 / percentAll] / nsPerUs;
+    state.counters["latency_p99_us"] = latency[latency.size() * percentile99 / percentAll] / nsPerUs;
+    state.counters["spin_hits"] = static_cast<double>(stats.busyPollHitCount);
+    state.counters["parks"] = static_cast<double>(stats.busyPollParkCount);
+}
+BENCHMARK(BenchmarkBusyPollLatency)->Arg(0)->Arg(50)->Iterations(2000)->UseRealTime();
+
+/**
+ * Throughput of distributing a burst of tiny tasks, picked one by one (1) or in batches of the given size.
+ */
+static void BenchmarkDistributeTinyTasks(benchmark::State &state)
+{
+    constexpr uint32_t taskCount = 512;
+    EventRunnerOptions options;
+    options.pickBatchSize = static_cast<uint32_t>(state.range(0));
+    auto runner = EventRunner::Create(std::string("BenchmarkDistributeTinyTasks"), options);
+    auto handler = std::make_shared<EventHandler>(runner);
+
+    std::mutex lock;
+    std::condition_variable condition;
+    bool held = false;
+    bool released = false;
+    std::atomic<uint32_t> remaining(0);
+    std::vector<TaskSpec> tasks;
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Hold the runner until all the tasks are posted, so that only distributing them is measured.
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            held = false;
+            released = false;
+            remaining.store(taskCount);
+        }
+        handler->PostTask([&lock, &condition, &held, &released]() {
+            std::unique_lock<std::mutex> guard(lock);
+            held = true;
+            condition.notify_all();
+            condition.wait(guard, [&released]() { return released; });
+        });
+        tasks.clear();
+        for (uint32_t i = 0; i < taskCount; ++i) {
+            tasks.emplace_back([&lock, &condition, &remaining]() {
+                // Only the last one takes the lock, others are as tiny as possible.
+                if (remaining.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> guard(lock);
+                    condition.notify_all();
+                }
+            });
+        }
+        std::unique_lock<std::mutex> guard(lock);
+        condition.wait(guard, [&held]() { return held; });
+        guard.unlock();
+        handler->PostTasks(tasks);
+        guard.lock();
+        released = true;
+        condition.notify_all();
+        state.ResumeTiming();
+        condition.wait(guard, [&remaining]() { return remaining.load() == 0; });
+    }
+    state.SetItemsProcessed(state.iterations() * taskCount);
+}
+BENCHMARK(BenchmarkDistributeTinyTasks)->Arg(1)->Arg(8)->Arg(32)->UseRealTime();
+
+BENCHMARK_MAIN();